@@ -18,6 +18,8 @@ public class OpenTournament : ModuleRules
                 "Engine",
                 "EngineSettings",
                 "InputCore",
+                "NetCore",
+                "ReplicationGraph",
                 "UMG",
                 "Slate",
                 "SlateCore",
@@ -3,7 +3,9 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "OpenTournament.h"
+#include "Engine/World.h"
 #include "Modules/ModuleManager.h"
+#include "UObject/ObjectKey.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -16,6 +18,45 @@ DEFINE_LOG_CATEGORY(GameUI);
 DEFINE_LOG_CATEGORY(Net);
 DEFINE_LOG_CATEGORY(LogWeapon);
 
+DEFINE_STAT(STAT_OT_PushModelDirtyMarks);
+DEFINE_STAT(STAT_OT_PushModelSkippedComparisons);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if STATS
+/** Marks since the last net update, by object */
+static TMap<FObjectKey, int32> PushModelPendingMarks;
+
+static bool IsPushModelServer(const UObject* Object)
+{
+    const UWorld* World = Object ? Object->GetWorld() : nullptr;
+    return World && World->GetNetMode() != NM_Client && World->GetNetMode() != NM_Standalone;
+}
+#endif
+
+void GamePushModelMarked(const UObject* Object)
+{
+#if STATS
+    if (IsPushModelServer(Object))
+    {
+        INC_DWORD_STAT(STAT_OT_PushModelDirtyMarks);
+        PushModelPendingMarks.FindOrAdd(Object)++;
+    }
+#endif
+}
+
+void GamePushModelNetUpdate(const UObject* Object, int32 NumPushProperties)
+{
+#if STATS
+    if (IsPushModelServer(Object))
+    {
+        int32 Marks = 0;
+        PushModelPendingMarks.RemoveAndCopyValue(Object, Marks);
+        INC_DWORD_STAT_BY(STAT_OT_PushModelSkippedComparisons, FMath::Max(NumPushProperties - Marks, 0));
+    }
+#endif
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 FCollisionResponseParams WorldResponseParams = []()
@@ -6,6 +6,8 @@
 
 #include "CoreMinimal.h"
 #include "CollisionQueryParams.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Stats/Stats.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -14,12 +16,42 @@ DECLARE_LOG_CATEGORY_EXTERN(GameUI, Log, All);
 DECLARE_LOG_CATEGORY_EXTERN(Net, Log, All);
 DECLARE_LOG_CATEGORY_EXTERN(LogWeapon, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("OpenTournament"), STATGROUP_OpenTournament, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Push Model Dirty Marks"), STAT_OT_PushModelDirtyMarks, STATGROUP_OpenTournament, OPENTOURNAMENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Push Model Skipped Comparisons"), STAT_OT_PushModelSkippedComparisons, STATGROUP_OpenTournament, OPENTOURNAMENT_API);
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define GAME_PRINT(Time, Color, Message, ...) (GEngine->AddOnScreenDebugMessage(-1, Time, Color, *FString::Printf(TEXT(Message), ##__VA_ARGS__)))
 
 #define GAME_LOG(Category, Level, Message, ...) UE_LOG(Category, Level, TEXT("[%s](Line: %d): %s"), *FString(__FUNCTION__), __LINE__, *FString::Printf(TEXT(Message), ##__VA_ARGS__))
 
+/**
+* Flag a push model property (FDoRepLifetimeParams::bIsPushBased) for comparison on the next net update.
+* The net driver skips comparing push model properties that were not marked since the last one.
+*/
+#define GAME_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) \
+    { \
+        GamePushModelMarked(Object); \
+        MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object); \
+    }
+
+/**
+* Push model stats, server only.
+* STAT_OT_PushModelDirtyMarks counts marks, see GAME_MARK_PROPERTY_DIRTY.
+* STAT_OT_PushModelSkippedComparisons counts, per net update, the push model properties of an object that were not marked.
+* Owners call GamePushModelNetUpdate from PreReplication with the number of push model properties of the object.
+*/
+OPENTOURNAMENT_API void GamePushModelMarked(const UObject* Object);
+OPENTOURNAMENT_API void GamePushModelNetUpdate(const UObject* Object, int32 NumPushProperties);
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
-extern FCollisionResponseParams WorldResponseParams;
\ No newline at end of file
+extern FCollisionResponseParams WorldResponseParams;
+
+/**
+* Mask filter bit for bodies that hitscan traces should always ignore (eg. non-damageable projectiles).
+* Evaluated by the physics query pre-filter, so these bodies never show up in hitscan results.
+*/
+#define MASKFILTER_HITSCAN_IGNORE 0x01
\ No newline at end of file
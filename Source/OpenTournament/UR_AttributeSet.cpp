@@ -29,17 +29,19 @@ void UUR_AttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(UUR_AttributeSet, Health);
-    DOREPLIFETIME(UUR_AttributeSet, HealthMax);
-    DOREPLIFETIME(UUR_AttributeSet, OverHealth);
-    DOREPLIFETIME(UUR_AttributeSet, OverHealthMax);
+    FDoRepLifetimeParams PushParams;
+    PushParams.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, Health, PushParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, HealthMax, PushParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, OverHealth, PushParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, OverHealthMax, PushParams);
     DOREPLIFETIME(UUR_AttributeSet, Energy);
     DOREPLIFETIME(UUR_AttributeSet, EnergyMax);
-    DOREPLIFETIME(UUR_AttributeSet, Armor);
-    DOREPLIFETIME(UUR_AttributeSet, ArmorMax);
-    DOREPLIFETIME(UUR_AttributeSet, ArmorAbsorptionPercent);
-    DOREPLIFETIME(UUR_AttributeSet, Shield);
-    DOREPLIFETIME(UUR_AttributeSet, ShieldMax);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, Armor, PushParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, ArmorMax, PushParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, ArmorAbsorptionPercent, PushParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, Shield, PushParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UUR_AttributeSet, ShieldMax, PushParams);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -49,6 +51,9 @@ void UUR_AttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute, f
     // This is called whenever attributes change, so for max health (etc) we want to scale the current totals to match
     Super::PreAttributeChange(Attribute, NewValue);
 
+    // Every current value update ends up here, including the Set* accessors which go through the base value
+    MarkAttributeDirty(Attribute);
+
     if (Attribute == GetHealthAttribute())
     {
         GAME_LOG(Game, Log, "Health - PreAttributeChange - New Value (%f)", NewValue);
@@ -59,6 +64,7 @@ void UUR_AttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute, f
         {
             const float OverflowValue = FMath::Clamp(NewValue - HealthMax.GetCurrentValue(), 0.f, OverHealthMax.GetCurrentValue());
             OverHealth.SetCurrentValue(OverHealth.GetCurrentValue() + OverflowValue);
+            MarkAttributeDirty(GetOverHealthAttribute());
         }
     }
     else if (Attribute == GetOverHealthAttribute())
@@ -92,6 +98,46 @@ void UUR_AttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbac
     Super::PostGameplayEffectExecute(Data);
 }
 
+void UUR_AttributeSet::MarkAttributeDirty(const FGameplayAttribute& Attribute)
+{
+    if (Attribute == GetHealthAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, Health, this);
+    }
+    else if (Attribute == GetHealthMaxAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, HealthMax, this);
+    }
+    else if (Attribute == GetOverHealthAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, OverHealth, this);
+    }
+    else if (Attribute == GetOverHealthMaxAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, OverHealthMax, this);
+    }
+    else if (Attribute == GetArmorAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, Armor, this);
+    }
+    else if (Attribute == GetArmorMaxAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, ArmorMax, this);
+    }
+    else if (Attribute == GetArmorAbsorptionPercentAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, ArmorAbsorptionPercent, this);
+    }
+    else if (Attribute == GetShieldAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, Shield, this);
+    }
+    else if (Attribute == GetShieldMaxAttribute())
+    {
+        GAME_MARK_PROPERTY_DIRTY(UUR_AttributeSet, ShieldMax, this);
+    }
+}
+
 void UUR_AttributeSet::AdjustAttributeForMaxChange(FGameplayAttributeData& AffectedAttribute, const FGameplayAttributeData& MaxAttribute, float NewMaxValue, const FGameplayAttribute& AffectedAttributeProperty)
 {
     UAbilitySystemComponent* AbilityComponent = GetOwningAbilitySystemComponent();
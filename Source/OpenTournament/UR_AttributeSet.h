@@ -36,6 +36,9 @@ public:
     virtual void PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data) override;
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+    /** Number of push model replicated attributes, see MarkAttributeDirty */
+    static const int32 NumPushModelAttributes = 9;
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
     UPROPERTY(ReplicatedUsing=OnRep_Health, BlueprintReadWrite, EditInstanceOnly, Category = "CharacterAttributes")
@@ -127,6 +130,12 @@ public:
 
 protected:
 
+    /**
+    * Health, armor and shield attributes are push model replicated.
+    * Flag the property backing Attribute for the next net update, no-op for the other attributes.
+    */
+    void MarkAttributeDirty(const FGameplayAttribute& Attribute);
+
     /**
     * Helper function to proportionally adjust the value of an attribute when it's associated max attribute changes.
     * (i.e. When MaxHealth increases, Health increases by an amount that maintains the same percentage as before)
@@ -14,7 +14,10 @@
 
 #include "OpenTournament.h"
 #include "UR_InventoryComponent.h"
+#include "UR_LagCompensationComponent.h"
 #include "UR_CharacterMovementComponent.h"
+#include "UR_DamageSubsystem.h"
+#include "UR_DamageableRegistrySubsystem.h"
 #include "UR_AttributeSet.h"
 #include "UR_AbilitySystemComponent.h"
 #include "UR_GameplayAbility.h"
@@ -47,6 +50,8 @@ AUR_Character::AUR_Character(const FObjectInitializer& ObjectInitializer) :
 
     InventoryComponent = Cast<UUR_InventoryComponent>(CreateDefaultSubobject<UUR_InventoryComponent>(TEXT("InventoryComponent")));
 
+    LagCompensationComponent = CreateDefaultSubobject<UUR_LagCompensationComponent>(TEXT("LagCompensationComponent"));
+
     // Create a CameraComponent	
     CharacterCameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("FirstPersonCamera"));
     CharacterCameraComponent->SetupAttachment(GetCapsuleComponent());
@@ -106,6 +111,14 @@ void AUR_Character::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
     DOREPLIFETIME(AUR_Character, AbilitySystemComponent);
 }
 
+void AUR_Character::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+    Super::PreReplication(ChangedPropertyTracker);
+
+    // Attribute set replicates along with us, as a subobject of the ability system component
+    GamePushModelNetUpdate(AttributeSet, UUR_AttributeSet::NumPushModelAttributes);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 void AUR_Character::BeginPlay()
@@ -117,6 +130,21 @@ void AUR_Character::BeginPlay()
     AttributeSet->SetArmor(100.f);
     AttributeSet->SetArmorMax(100.f);
     AttributeSet->SetShieldMax(100.f);
+
+    if (UUR_DamageableRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UUR_DamageableRegistrySubsystem>())
+    {
+        Registry->Register(this);
+    }
+}
+
+void AUR_Character::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UUR_DamageableRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UUR_DamageableRegistrySubsystem>())
+    {
+        Registry->Unregister(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void AUR_Character::Tick(float DeltaTime)
@@ -609,8 +637,6 @@ void AUR_Character::OnWallDodge_Implementation(const FVector& DodgeLocation, con
 
 float AUR_Character::TakeDamage(float Damage, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-    GAME_LOG(Game, Log, "Damage Incoming (%f)", Damage);
-
     if (!ShouldTakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser))
     {
         return 0.f;
@@ -619,55 +645,65 @@ float AUR_Character::TakeDamage(float Damage, FDamageEvent const& DamageEvent, A
     // Super() takes care of calculating proper splash damage values and imparting components physics.
     // Then it triggers events : OnTakePointDamage, OnTakeRadialDamage, OnTakeAnyDamage.
     Damage = FMath::FloorToFloat(Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser));
-    //GAME_PRINT(10.f, FColor::Purple, "Damage Floor (%f)", DamageToArmor);
-    GAME_LOG(Game, Log, "Damage Incoming Floor (%f)", Damage);
-
-    float TotalDamage = Damage;
-
-    if (AttributeSet)
+    if (Damage <= 0.f)
     {
-        if (AttributeSet->Health.GetCurrentValue() > 0.f)
-        {
-            const float CurrentShield = FMath::FloorToFloat(AttributeSet->Shield.GetCurrentValue());
-            if (CurrentShield > 0.f)
-            {
-                //GAME_PRINT(10.f, FColor::Yellow, "Damage to Shield (%f)", FMath::Min(Damage, CurrentShield));
-                GAME_LOG(Game, Log, "Damage to Shield (%f)", FMath::Min(Damage, CurrentShield));
-
-                AttributeSet->SetShield(FMath::FloorToFloat(FMath::Max(CurrentShield - Damage, 0.f)));
-                Damage = CurrentShield - Damage > 0.f ? 0.f : Damage - CurrentShield;
-            }
-
-            const float CurrentArmor = FMath::FloorToFloat(AttributeSet->Armor.GetCurrentValue());
-            const float ArmorAbsorption = AttributeSet->ArmorAbsorptionPercent.GetCurrentValue();
-            if (CurrentArmor > 0.f && Damage > 0.f)
-            {
-                const float DamageToArmor = FMath::FloorToFloat(FMath::Min(Damage * ArmorAbsorption, CurrentArmor));
-
-                //GAME_PRINT(10.f, FColor::Emerald, "Damage to Armor (%f)", DamageToArmor);
-                GAME_LOG(Game, Log, "Damage to Armor (%f)", DamageToArmor);
-
-                AttributeSet->SetArmor(FMath::Max(CurrentArmor - DamageToArmor, 0.f));
-                Damage = FMath::Max(Damage - DamageToArmor, 0.f);
-            }
+        return 0.f;
+    }
 
-            const float CurrentHealth = AttributeSet->Health.GetCurrentValue();
-            if (CurrentHealth > 0.f && Damage > 0.f)
-            {
-                //GAME_PRINT(10.f, FColor::Red, "Damage to Health (%f)", Damage);
-                GAME_LOG(Game, Log, "Damage to Health (%f)", Damage);
+    const bool bWasPending = PendingDamage.Num() > 0;
 
-                AttributeSet->SetHealth(FMath::FloorToFloat(FMath::Max(CurrentHealth - Damage, 0.f)));
+    const int32 DamageEventClassID = DamageEvent.GetTypeID();
+    FUR_PendingDamage* Entry = PendingDamage.FindByPredicate([EventInstigator, &DamageEvent, DamageEventClassID](const FUR_PendingDamage& Other)
+    {
+        return Other.Instigator.Get() == EventInstigator
+            && Other.DamageTypeClass == DamageEvent.DamageTypeClass
+            && Other.DamageEventClassID == DamageEventClassID;
+    });
+    if (!Entry)
+    {
+        Entry = &PendingDamage.AddDefaulted_GetRef();
+        Entry->Instigator = EventInstigator;
+        Entry->DamageTypeClass = DamageEvent.DamageTypeClass;
+        Entry->DamageEventClassID = DamageEventClassID;
+        Entry->Damage = 0.f;
+        Entry->Knockback = FVector::ZeroVector;
+    }
+    Entry->DamageCauser = DamageCauser;
+    if (DamageEvent.IsOfType(FPointDamageEvent::ClassID))
+    {
+        const FPointDamageEvent* PointDamageEvent = (const FPointDamageEvent*)&DamageEvent;
+        Entry->HitInfo = PointDamageEvent->HitInfo;
+        Entry->ShotDirection = PointDamageEvent->ShotDirection;
+    }
+    else if (DamageEvent.IsOfType(FRadialDamageEvent::ClassID))
+    {
+        const FRadialDamageEvent* RadialDamageEvent = (const FRadialDamageEvent*)&DamageEvent;
+        Entry->HitInfo = RadialDamageEvent->ComponentHits.Num() > 0 ? RadialDamageEvent->ComponentHits[0] : FHitResult();
+        Entry->Origin = RadialDamageEvent->Origin;
+        Entry->RadialParams = RadialDamageEvent->Params;
+    }
+    Entry->Damage += Damage;
+    Entry->Knockback += GetDamageKnockback(Damage, DamageEvent);
 
-                // @! TODO Limit Pain by time, vary by damage etc.
-                if (Damage > 10.f)
-                {
-                    UGameplayStatics::PlaySoundAtLocation(this, CharacterVoice.PainSound, GetActorLocation(), GetActorRotation());
-                }
-            }
+    UUR_DamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UUR_DamageSubsystem>();
+    if (DamageSubsystem && DamageSubsystem->IsCoalescingEnabled())
+    {
+        if (!bWasPending)
+        {
+            DamageSubsystem->AddPendingVictim(this);
         }
     }
+    else
+    {
+        ResolvePendingDamage();
+    }
+
+    // Before shield and armor absorption
+    return Damage;
+}
 
+FVector AUR_Character::GetDamageKnockback(float Damage, FDamageEvent const& DamageEvent) const
+{
     //NOTE: it seems like we are lacking control of damage momentum (knockback) overall.
     // DamageType has DamageImpulse but it is part of CDO, which is a bit annoying.
     // We cannot adjust DamageImpulse on the fly with gamemode/mutators.
@@ -680,46 +716,144 @@ float AUR_Character::TakeDamage(float Damage, FDamageEvent const& DamageEvent, A
     // And finally, apply knockback manually with a custom impulse.
 
     // For now, let's try basic values
-    float KnockbackPower = 1500.f * TotalDamage;
+    const float KnockbackPower = 1500.f * Damage;
 
-    // Avoid very small knockbacks
-    if (KnockbackPower / GetCharacterMovement()->Mass >= 100.f)
+    if (DamageEvent.IsOfType(FPointDamageEvent::ClassID))
+    {
+        const FPointDamageEvent* PointDamageEvent = (const FPointDamageEvent*)&DamageEvent;
+
+        // Always use shot direction for knockback, biased towards +Z
+        const FVector KnockbackDir = 0.75f*PointDamageEvent->ShotDirection + FVector(0, 0, 0.25f);
+        return KnockbackPower * KnockbackDir;
+    }
+    else if (DamageEvent.IsOfType(FRadialDamageEvent::ClassID))
     {
-        FVector KnockbackDir;
-        if (DamageEvent.IsOfType(FPointDamageEvent::ClassID))
+        const FRadialDamageEvent* RadialDamageEvent = (const FRadialDamageEvent*)&DamageEvent;
+
+        // Same as CharacterMovement AddRadialImpulse with constant falloff, because we already scaled KnockbackPower
+        const FVector Delta = GetActorLocation() - RadialDamageEvent->Origin;
+        if (Delta.SizeSquared() > FMath::Square(RadialDamageEvent->Params.GetMaxRadius()))
         {
-            FPointDamageEvent* PointDamageEvent = (FPointDamageEvent*)&DamageEvent;
+            return FVector::ZeroVector;
+        }
+        return KnockbackPower * Delta.GetSafeNormal();
+    }
+
+    return FVector::ZeroVector;
+}
+
+void AUR_Character::ResolvePendingDamage()
+{
+    // Damage dealt from here (eg. death) starts a new set of entries
+    Swap(PendingDamage, ResolvingDamage);
 
-            // Always use shot direction for knockback
-            KnockbackDir = PointDamageEvent->ShotDirection;
-            // Bias towards +Z
-            KnockbackDir = 0.75*KnockbackDir + FVector(0, 0, 0.25);
+    if (ResolvingDamage.Num() == 0 || !AttributeSet || GetTearOff() || IsPendingKillPending())
+    {
+        ResolvingDamage.Reset();
+        return;
+    }
+
+    const float StartShield = FMath::FloorToFloat(AttributeSet->Shield.GetCurrentValue());
+    const float StartArmor = FMath::FloorToFloat(AttributeSet->Armor.GetCurrentValue());
+    const float StartHealth = AttributeSet->Health.GetCurrentValue();
+    const float ArmorAbsorption = AttributeSet->ArmorAbsorptionPercent.GetCurrentValue();
+
+    float Shield = StartShield;
+    float Armor = StartArmor;
+    float Health = StartHealth;
+    float TotalDamage = 0.f;
+    float DamageToHealth = 0.f;
+    FVector Knockback = FVector::ZeroVector;
+    int32 KillerIndex = INDEX_NONE;
+
+    // Run the cascade entry by entry, so we know whose damage brought health to zero
+    for (int32 i = 0; i < ResolvingDamage.Num(); i++)
+    {
+        const FUR_PendingDamage& Entry = ResolvingDamage[i];
+        TotalDamage += Entry.Damage;
+        Knockback += Entry.Knockback;
+
+        if (Health <= 0.f)
+        {
+            continue;
+        }
+
+        float Damage = Entry.Damage;
+        if (Shield > 0.f)
+        {
+            const float DamageToShield = FMath::Min(Damage, Shield);
+            Shield -= DamageToShield;
+            Damage -= DamageToShield;
+        }
 
-            GetCharacterMovement()->AddImpulse(KnockbackPower*KnockbackDir);
+        if (Armor > 0.f && Damage > 0.f)
+        {
+            const float DamageToArmor = FMath::FloorToFloat(FMath::Min(Damage * ArmorAbsorption, Armor));
+            Armor = FMath::Max(Armor - DamageToArmor, 0.f);
+            Damage = FMath::Max(Damage - DamageToArmor, 0.f);
         }
-        else if (DamageEvent.IsOfType(FRadialDamageEvent::ClassID))
+
+        if (Damage > 0.f)
         {
-            FRadialDamageEvent* RadialDamageEvent = (FRadialDamageEvent*)&DamageEvent;
+            DamageToHealth += Damage;
+            Health = FMath::FloorToFloat(FMath::Max(Health - Damage, 0.f));
+            if (Health <= 0.f)
+            {
+                KillerIndex = i;
+            }
+        }
+    }
 
-            // Use no falloff (constant) because we already scaled KnockbackPower
-            GetCharacterMovement()->AddRadialImpulse(RadialDamageEvent->Origin, RadialDamageEvent->Params.GetMaxRadius(), KnockbackPower, ERadialImpulseFalloff::RIF_Constant, false);
+    GAME_LOG(Game, Log, "Damage Resolved (%f) from %d sources: Shield (%f) Armor (%f) Health (%f)", TotalDamage, ResolvingDamage.Num(), StartShield - Shield, StartArmor - Armor, DamageToHealth);
 
-            /*
-            // Experimental: use vector (HitLocation->EyeLocation) as knockback direction to make it feel more natural
+    if (Shield != StartShield)
+    {
+        AttributeSet->SetShield(Shield);
+    }
+    if (Armor != StartArmor)
+    {
+        AttributeSet->SetArmor(Armor);
+    }
+    if (Health != StartHealth)
+    {
+        AttributeSet->SetHealth(Health);
 
-            KnockbackDir = (GetPawnViewLocation() - RadialDamageEvent->Origin);
-            KnockbackDir.Normalize();
-            GetCharacterMovement()->AddImpulse(KnockbackPower*KnockbackDir);
-            */
+        // @! TODO Limit Pain by time, vary by damage etc.
+        if (DamageToHealth > 10.f)
+        {
+            UGameplayStatics::PlaySoundAtLocation(this, CharacterVoice.PainSound, GetActorLocation(), GetActorRotation());
         }
     }
 
+    // Avoid very small knockbacks
+    if (Knockback.Size() / GetCharacterMovement()->Mass >= 100.f)
+    {
+        GetCharacterMovement()->AddImpulse(Knockback);
+    }
+
     if (AttributeSet->Health.GetCurrentValue() <= 0)
     {
-        Die(EventInstigator, DamageEvent, DamageCauser);
+        const FUR_PendingDamage& Killing = ResolvingDamage[KillerIndex != INDEX_NONE ? KillerIndex : ResolvingDamage.Num() - 1];
+        if (Killing.DamageEventClassID == FPointDamageEvent::ClassID)
+        {
+            Die(Killing.Instigator.Get(), FPointDamageEvent(Killing.Damage, Killing.HitInfo, Killing.ShotDirection, Killing.DamageTypeClass), Killing.DamageCauser.Get());
+        }
+        else if (Killing.DamageEventClassID == FRadialDamageEvent::ClassID)
+        {
+            FRadialDamageEvent RadialDamageEvent;
+            RadialDamageEvent.DamageTypeClass = Killing.DamageTypeClass;
+            RadialDamageEvent.Origin = Killing.Origin;
+            RadialDamageEvent.Params = Killing.RadialParams;
+            RadialDamageEvent.ComponentHits.Add(Killing.HitInfo);
+            Die(Killing.Instigator.Get(), RadialDamageEvent, Killing.DamageCauser.Get());
+        }
+        else
+        {
+            Die(Killing.Instigator.Get(), FDamageEvent(Killing.DamageTypeClass), Killing.DamageCauser.Get());
+        }
     }
 
-    return Damage;
+    ResolvingDamage.Reset();
 }
 
 void AUR_Character::Die(AController* Killer, const FDamageEvent& DamageEvent, AActor* DamageCauser)
@@ -21,6 +21,7 @@ class UUR_AbilitySystemComponent;
 class UUR_AttributeSet;
 class UUR_GameplayAbility;
 class UUR_InventoryComponent;
+class UUR_LagCompensationComponent;
 class APlayerController;
 class IUR_ActivatableInterface;
 
@@ -47,6 +48,40 @@ struct FCharacterVoice
     USoundBase* PainSound;
 };
 
+/**
+* Damage received during the current frame from one instigator, with one damage type and one kind of event.
+* A direct hit and the splash of the same rocket are two entries, so the killing one is reported as is.
+* See AUR_Character::ResolvePendingDamage.
+*/
+struct FUR_PendingDamage
+{
+    TWeakObjectPtr<AController> Instigator;
+
+    /** Type of the events, used for kill credit */
+    TSubclassOf<UDamageType> DamageTypeClass;
+
+    /** Kind of the events, rebuilt as such for Die. See FDamageEvent::GetTypeID */
+    int32 DamageEventClassID;
+
+    /** Causer of the most recent event, used for kill credit */
+    TWeakObjectPtr<AActor> DamageCauser;
+
+    /** Hit of the most recent point damage, or first component hit of radial damage */
+    FHitResult HitInfo;
+
+    /** Point damage only */
+    FVector ShotDirection;
+
+    /** Radial damage only */
+    FVector Origin;
+    FRadialDamageParams RadialParams;
+
+    float Damage;
+
+    /** Sum of knockback impulses */
+    FVector Knockback;
+};
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -118,7 +153,9 @@ public:
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
     virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
     virtual void CalcCamera(float DeltaTime, struct FMinimalViewInfo& OutResult) override;
@@ -473,9 +510,23 @@ public:
 
     /**
     * Take Damage override.
+    * Damage is accumulated per instigator, damage type and kind of event, and resolved at the end of the frame by UUR_DamageSubsystem.
+    * Returns the damage before shield and armor absorption, which only happen in ResolvePendingDamage.
     */
     virtual float TakeDamage(float Damage, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
+    /**
+    * Apply all damage accumulated this frame at once.
+    * One shield/armor/health cascade, one attribute write set, one knockback impulse and one death check.
+    * Kill credit goes to the instigator whose damage brought health to zero.
+    */
+    virtual void ResolvePendingDamage();
+
+    /**
+    * Knockback impulse resulting from a single damage event.
+    */
+    virtual FVector GetDamageKnockback(float Damage, FDamageEvent const& DamageEvent) const;
+
     /**
     * Kill this player.
     * Authority only.
@@ -507,6 +558,22 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure)
     bool IsAlive() const;
 
+    /**
+    * Hitbox history, used by authority to rewind hitboxes when processing client shots.
+    */
+    UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Character")
+    UUR_LagCompensationComponent* LagCompensationComponent;
+
+protected:
+
+    /** Damage received this frame, one entry per instigator, damage type and kind of event, in order of first hit */
+    TArray<FUR_PendingDamage> PendingDamage;
+
+    /** Entries being resolved. Kept around to reuse allocations */
+    TArray<FUR_PendingDamage> ResolvingDamage;
+
+public:
+
     UFUNCTION(Exec)
     virtual void Suicide()
     {
@@ -40,7 +40,11 @@ void UUR_CheatManager::Cheat_Loaded()
             {
                 const auto World = URCharacter->GetWorld();
                 auto SpawnedWeapon = World->SpawnActor<AUR_Weapon>(WeaponClass);
-                Inventory->Add(SpawnedWeapon);
+                if (SpawnedWeapon)
+                {
+                    // Owned weapons only replicate as dependents of their character
+                    SpawnedWeapon->GiveTo(URCharacter);
+                }
             }            
         }
     }
@@ -0,0 +1,411 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_CosmeticEventSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Components/AudioComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Sound/SoundBase.h"
+
+#include "OpenTournament.h"
+#include "UR_FunctionLibrary.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetics Spawned"), STAT_OT_CosmeticsSpawned, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetics Reused"), STAT_OT_CosmeticsReused, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetics Culled"), STAT_OT_CosmeticsCulled, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetics Merged"), STAT_OT_CosmeticsMerged, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetics Over Budget"), STAT_OT_CosmeticsOverBudget, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetics Saturated"), STAT_OT_CosmeticsSaturated, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetics Evicted"), STAT_OT_CosmeticsEvicted, STATGROUP_OpenTournament);
+
+static TAutoConsoleVariable<int32> CVarCosmeticBudgeting(
+    TEXT("ot.CosmeticBudgeting"),
+    1,
+    TEXT("Pool, budget, cull and merge cosmetic weapon events.\n")
+    TEXT("0: spawn every effect and sound\n")
+    TEXT("1: budgeted (default)"),
+    ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarCosmeticSpawnBudget(
+    TEXT("ot.CosmeticSpawnBudget"),
+    24,
+    TEXT("Maximum number of cosmetic effects and sounds started per frame."),
+    ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarCosmeticMaxPerTemplate(
+    TEXT("ot.CosmeticMaxPerTemplate"),
+    12,
+    TEXT("Maximum number of instances of a single effect or sound playing at once."),
+    ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarCosmeticCullDistance(
+    TEXT("ot.CosmeticCullDistance"),
+    10000.f,
+    TEXT("Effects further than this from the local view are not spawned."),
+    ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarCosmeticMergeDistance(
+    TEXT("ot.CosmeticMergeDistance"),
+    32.f,
+    TEXT("Identical impacts within this distance in the same frame are played once."),
+    ECVF_Scalability);
+
+/** Effects this close to the view are always spawned, they may cover the screen regardless of direction */
+static const float AlwaysRelevantDistance = 512.f;
+
+/** Widen the view cone, effects have some extent */
+static const float ViewConeMargin = 15.f;
+
+static bool IsBudgetingEnabled()
+{
+    return CVarCosmeticBudgeting.GetValueOnGameThread() != 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_CosmeticEventSubsystem::Deinitialize()
+{
+    for (auto& Pair : Pools)
+    {
+        for (USceneComponent* Component : Pair.Value.Components)
+        {
+            if (IsValid(Component))
+            {
+                Component->DestroyComponent();
+            }
+        }
+    }
+    Pools.Empty();
+    FrameImpacts.Empty();
+
+    Super::Deinitialize();
+}
+
+bool UUR_CosmeticEventSubsystem::IsCosmeticWorld() const
+{
+    return GetWorld() && GetWorld()->GetNetMode() != NM_DedicatedServer;
+}
+
+bool UUR_CosmeticEventSubsystem::ConsumeBudget(bool bImportant)
+{
+    if (!bImportant && FrameSpawns >= CVarCosmeticSpawnBudget.GetValueOnGameThread())
+    {
+        INC_DWORD_STAT(STAT_OT_CosmeticsOverBudget);
+        return false;
+    }
+    FrameSpawns++;
+    return true;
+}
+
+bool UUR_CosmeticEventSubsystem::IsRelevantEffectLocation(const FVector& Location) const
+{
+    if (!bHasView)
+    {
+        return true;
+    }
+
+    const FVector Delta = Location - ViewLocation;
+    const float DistSq = Delta.SizeSquared();
+    if (DistSq > FMath::Square(CVarCosmeticCullDistance.GetValueOnGameThread()))
+    {
+        return false;
+    }
+    if (DistSq < FMath::Square(AlwaysRelevantDistance))
+    {
+        return true;
+    }
+    return (Delta * FMath::InvSqrt(DistSq) | ViewDirection) >= ViewCosHalfAngle;
+}
+
+bool UUR_CosmeticEventSubsystem::IsRelevantEffectSegment(const FVector& Start, const FVector& End) const
+{
+    if (!bHasView)
+    {
+        return true;
+    }
+
+    // Closest point decides distance, any of the three may be in the view cone
+    const FVector Closest = FMath::ClosestPointOnSegment(ViewLocation, Start, End);
+    if (FVector::DistSquared(Closest, ViewLocation) > FMath::Square(CVarCosmeticCullDistance.GetValueOnGameThread()))
+    {
+        return false;
+    }
+    return IsRelevantEffectLocation(Closest) || IsRelevantEffectLocation(Start) || IsRelevantEffectLocation(End);
+}
+
+bool UUR_CosmeticEventSubsystem::IsComponentBusy(const USceneComponent* Component)
+{
+    if (const UAudioComponent* Audio = Cast<UAudioComponent>(Component))
+    {
+        return Audio->IsPlaying();
+    }
+    if (const UParticleSystemComponent* PSC = Cast<UParticleSystemComponent>(Component))
+    {
+        return PSC->IsActive() && !PSC->bWasCompleted;
+    }
+    return Component->IsActive();
+}
+
+bool UUR_CosmeticEventSubsystem::FindIdleComponent(UObject* Template, bool bImportant, USceneComponent*& OutComponent, FUR_CosmeticPool*& OutPool)
+{
+    FUR_CosmeticPool& Pool = Pools.FindOrAdd(Template);
+    OutPool = &Pool;
+    OutComponent = nullptr;
+
+    // Components may have been destroyed along with their outer
+    Pool.Components.RemoveAllSwap([](const USceneComponent* Component) { return !IsValid(Component); });
+
+    const int32 Num = Pool.Components.Num();
+    for (int32 i = 0; i < Num; i++)
+    {
+        const int32 Index = (Pool.NextIndex + i) % Num;
+        if (!IsComponentBusy(Pool.Components[Index]))
+        {
+            OutComponent = Pool.Components[Index];
+            Pool.NextIndex = (Index + 1) % Num;
+            return true;
+        }
+    }
+
+    if (Num >= CVarCosmeticMaxPerTemplate.GetValueOnGameThread())
+    {
+        if (bImportant && Num > 0)
+        {
+            // Round-robin start is the least recently started component
+            const int32 Index = Pool.NextIndex % Num;
+            OutComponent = Pool.Components[Index];
+            Pool.NextIndex = (Index + 1) % Num;
+            INC_DWORD_STAT(STAT_OT_CosmeticsEvicted);
+            return true;
+        }
+        INC_DWORD_STAT(STAT_OT_CosmeticsSaturated);
+        return false;
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_CosmeticEventSubsystem::PlayImpact(UFXSystemAsset* Template, USoundBase* Sound, const FTransform& Transform)
+{
+    if (!IsCosmeticWorld())
+    {
+        return;
+    }
+
+    if (IsBudgetingEnabled())
+    {
+        const float MergeDistance = FMath::Max(CVarCosmeticMergeDistance.GetValueOnGameThread(), 1.f);
+        const FVector& Location = Transform.GetLocation();
+        const FIntVector Cell(FMath::FloorToInt(Location.X / MergeDistance), FMath::FloorToInt(Location.Y / MergeDistance), FMath::FloorToInt(Location.Z / MergeDistance));
+
+        bool bAlreadyPlayed = false;
+        FrameImpacts.Add(TPair<const UObject*, FIntVector>(Template ? (UObject*)Template : (UObject*)Sound, Cell), &bAlreadyPlayed);
+        if (bAlreadyPlayed)
+        {
+            INC_DWORD_STAT(STAT_OT_CosmeticsMerged);
+            return;
+        }
+    }
+
+    SpawnEffectAtLocation(Template, Transform);
+    PlaySoundAtLocation(Sound, Transform.GetLocation());
+}
+
+UFXSystemComponent* UUR_CosmeticEventSubsystem::SpawnEffectAtLocation(UFXSystemAsset* Template, const FTransform& Transform, bool bImportant)
+{
+    if (!Template || !IsCosmeticWorld())
+    {
+        return nullptr;
+    }
+
+    if (!IsBudgetingEnabled())
+    {
+        return UUR_FunctionLibrary::SpawnEffectAtLocation(GetWorld(), Template, Transform);
+    }
+
+    if (!bImportant && !IsRelevantEffectLocation(Transform.GetLocation()))
+    {
+        INC_DWORD_STAT(STAT_OT_CosmeticsCulled);
+        return nullptr;
+    }
+
+    return SpawnPooledEffect(Template, Transform, bImportant);
+}
+
+UFXSystemComponent* UUR_CosmeticEventSubsystem::SpawnBeamEffect(UFXSystemAsset* Template, const FVector& BeamStart, const FVector& BeamEnd, bool bImportant)
+{
+    if (!Template || !IsCosmeticWorld())
+    {
+        return nullptr;
+    }
+
+    if (!IsBudgetingEnabled())
+    {
+        return UUR_FunctionLibrary::SpawnEffectAtLocation(GetWorld(), Template, FTransform(BeamStart));
+    }
+
+    if (!bImportant && !IsRelevantEffectSegment(BeamStart, BeamEnd))
+    {
+        INC_DWORD_STAT(STAT_OT_CosmeticsCulled);
+        return nullptr;
+    }
+
+    return SpawnPooledEffect(Template, FTransform(BeamStart), bImportant);
+}
+
+UFXSystemComponent* UUR_CosmeticEventSubsystem::SpawnPooledEffect(UFXSystemAsset* Template, const FTransform& Transform, bool bImportant)
+{
+    USceneComponent* Idle;
+    FUR_CosmeticPool* Pool;
+    if (!FindIdleComponent(Template, bImportant, Idle, Pool) || !ConsumeBudget(bImportant))
+    {
+        return nullptr;
+    }
+
+    if (UFXSystemComponent* Effect = Cast<UFXSystemComponent>(Idle))
+    {
+        Effect->SetWorldTransform(Transform);
+        Effect->Activate(true);
+        INC_DWORD_STAT(STAT_OT_CosmeticsReused);
+        return Effect;
+    }
+
+    UFXSystemComponent* Effect = UUR_FunctionLibrary::SpawnEffectAtLocation(GetWorld(), Template, Transform, false, true);
+    if (Effect)
+    {
+        Pool->Components.Add(Effect);
+        INC_DWORD_STAT(STAT_OT_CosmeticsSpawned);
+    }
+    return Effect;
+}
+
+UFXSystemComponent* UUR_CosmeticEventSubsystem::SpawnEffectAttached(UFXSystemAsset* Template, USceneComponent* AttachToComponent, FName AttachPointName, bool bImportant)
+{
+    if (!Template || !AttachToComponent || !IsCosmeticWorld())
+    {
+        return nullptr;
+    }
+
+    if (IsBudgetingEnabled())
+    {
+        if (!bImportant && !IsRelevantEffectLocation(AttachToComponent->GetSocketLocation(AttachPointName)))
+        {
+            INC_DWORD_STAT(STAT_OT_CosmeticsCulled);
+            return nullptr;
+        }
+        if (!ConsumeBudget(bImportant))
+        {
+            return nullptr;
+        }
+    }
+
+    INC_DWORD_STAT(STAT_OT_CosmeticsSpawned);
+    return UUR_FunctionLibrary::SpawnEffectAttached(Template, FTransform(), AttachToComponent, AttachPointName, EAttachLocation::SnapToTargetIncludingScale);
+}
+
+UAudioComponent* UUR_CosmeticEventSubsystem::PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, bool bImportant)
+{
+    if (!Sound || !IsCosmeticWorld())
+    {
+        return nullptr;
+    }
+
+    if (!IsBudgetingEnabled())
+    {
+        return UGameplayStatics::SpawnSoundAtLocation(GetWorld(), Sound, Location);
+    }
+
+    // Sounds are audible behind us, only cull what attenuation would silence anyways
+    if (!bImportant && bHasView && FVector::DistSquared(Location, ViewLocation) > FMath::Square(Sound->GetMaxDistance()))
+    {
+        INC_DWORD_STAT(STAT_OT_CosmeticsCulled);
+        return nullptr;
+    }
+
+    USceneComponent* Idle;
+    FUR_CosmeticPool* Pool;
+    if (!FindIdleComponent(Sound, bImportant, Idle, Pool) || !ConsumeBudget(bImportant))
+    {
+        return nullptr;
+    }
+
+    if (UAudioComponent* Audio = Cast<UAudioComponent>(Idle))
+    {
+        Audio->SetWorldLocation(Location);
+        Audio->Play();
+        INC_DWORD_STAT(STAT_OT_CosmeticsReused);
+        return Audio;
+    }
+
+    UAudioComponent* Audio = UGameplayStatics::SpawnSoundAtLocation(GetWorld(), Sound, Location, FRotator::ZeroRotator, 1.f, 1.f, 0.f, nullptr, nullptr, false);
+    if (Audio)
+    {
+        Pool->Components.Add(Audio);
+        INC_DWORD_STAT(STAT_OT_CosmeticsSpawned);
+    }
+    return Audio;
+}
+
+UAudioComponent* UUR_CosmeticEventSubsystem::PlaySoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent, FName AttachPointName, bool bImportant)
+{
+    if (!Sound || !AttachToComponent || !IsCosmeticWorld())
+    {
+        return nullptr;
+    }
+
+    if (IsBudgetingEnabled())
+    {
+        if (!bImportant && bHasView && FVector::DistSquared(AttachToComponent->GetComponentLocation(), ViewLocation) > FMath::Square(Sound->GetMaxDistance()))
+        {
+            INC_DWORD_STAT(STAT_OT_CosmeticsCulled);
+            return nullptr;
+        }
+        if (!ConsumeBudget(bImportant))
+        {
+            return nullptr;
+        }
+    }
+
+    INC_DWORD_STAT(STAT_OT_CosmeticsSpawned);
+    return UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPointName, FVector(0), EAttachLocation::SnapToTarget);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_CosmeticEventSubsystem::Tick(float DeltaTime)
+{
+    FrameSpawns = 0;
+    FrameImpacts.Reset();
+
+    // Capture the view for next frame's events. With split screen there is no single view to cull against.
+    bHasView = false;
+    APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    if (PC && PC->PlayerCameraManager && GEngine->GetNumGamePlayers(GetWorld()) == 1)
+    {
+        ViewLocation = PC->PlayerCameraManager->GetCameraLocation();
+        ViewDirection = PC->PlayerCameraManager->GetCameraRotation().Vector();
+        const float HalfAngle = FMath::Min(0.5f * PC->PlayerCameraManager->GetFOVAngle() + ViewConeMargin, 180.f);
+        ViewCosHalfAngle = FMath::Cos(FMath::DegreesToRadians(HalfAngle));
+        bHasView = true;
+    }
+}
+
+ETickableTickType UUR_CosmeticEventSubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_CosmeticEventSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_CosmeticEventSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_CosmeticEventSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class UAudioComponent;
+class UFXSystemAsset;
+class UFXSystemComponent;
+class USceneComponent;
+class USoundBase;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Reusable components of a single FX or sound template.
+*/
+USTRUCT()
+struct FUR_CosmeticPool
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<USceneComponent*> Components;
+
+    /** Round-robin start of the search for an idle component */
+    int32 NextIndex;
+
+    FUR_CosmeticPool()
+        : NextIndex(0)
+    {}
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Client-side manager for cosmetic weapon events (impacts, muzzle flashes, beams, fire sounds).
+*
+* - Effects and sounds spawned at a location are pooled per template, and reused once finished.
+* - At most ot.CosmeticMaxPerTemplate instances of a template play at once. Important events replace the oldest instance instead.
+* - At most ot.CosmeticSpawnBudget events start per frame. Events flagged important (eg. our own weapon) ignore the budget.
+* - Effects outside the local view cone or beyond ot.CosmeticCullDistance are skipped. Beams are tested along their whole segment.
+*   Sounds are only skipped beyond their attenuation distance.
+* - Identical impacts at about the same location within a frame are merged.
+*
+* Attached effects and sounds follow the budget and culling rules, but are not pooled since they live on their parent.
+* Does nothing on dedicated servers. Can be toggled at runtime with ot.CosmeticBudgeting.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_CosmeticEventSubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Play effect and sound of an impact. Merged with identical impacts of the same frame.
+    */
+    void PlayImpact(UFXSystemAsset* Template, USoundBase* Sound, const FTransform& Transform);
+
+    /**
+    * Spawn or reuse an effect at location.
+    * Returned component is only valid until it finishes, do not keep it around.
+    */
+    UFXSystemComponent* SpawnEffectAtLocation(UFXSystemAsset* Template, const FTransform& Transform, bool bImportant = false);
+
+    /**
+    * Spawn or reuse a beam effect at BeamStart.
+    * Culled only if no part of the segment is relevant to the local view. Caller sets the beam end parameter.
+    */
+    UFXSystemComponent* SpawnBeamEffect(UFXSystemAsset* Template, const FVector& BeamStart, const FVector& BeamEnd, bool bImportant = false);
+
+    /**
+    * Spawn an effect snapped to a socket.
+    */
+    UFXSystemComponent* SpawnEffectAttached(UFXSystemAsset* Template, USceneComponent* AttachToComponent, FName AttachPointName, bool bImportant = false);
+
+    /**
+    * Play or reuse a sound at location.
+    */
+    UAudioComponent* PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, bool bImportant = false);
+
+    /**
+    * Play a sound snapped to a socket.
+    */
+    UAudioComponent* PlaySoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent, FName AttachPointName, bool bImportant = false);
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    /**
+    * Whether cosmetics should be rendered at all in this world.
+    */
+    bool IsCosmeticWorld() const;
+
+    /**
+    * Consume one spawn from this frame's budget.
+    */
+    bool ConsumeBudget(bool bImportant);
+
+    /**
+    * Whether an effect at this location is worth spawning for the local viewer.
+    */
+    bool IsRelevantEffectLocation(const FVector& Location) const;
+
+    /**
+    * Whether any part of a segment is worth spawning an effect for, for the local viewer.
+    */
+    bool IsRelevantEffectSegment(const FVector& Start, const FVector& End) const;
+
+    /**
+    * Reuse or spawn an effect at location, once culling has been done.
+    */
+    UFXSystemComponent* SpawnPooledEffect(UFXSystemAsset* Template, const FTransform& Transform, bool bImportant);
+
+    /**
+    * Find an idle component of given template.
+    * Returns false if the template is playing its maximum number of instances already.
+    * Important events instead get the oldest playing component, to be restarted.
+    */
+    bool FindIdleComponent(UObject* Template, bool bImportant, USceneComponent*& OutComponent, FUR_CosmeticPool*& OutPool);
+
+    static bool IsComponentBusy(const USceneComponent* Component);
+
+    UPROPERTY()
+    TMap<UObject*, FUR_CosmeticPool> Pools;
+
+    /** Impacts played this frame, by template and quantized location */
+    TSet<TPair<const UObject*, FIntVector>> FrameImpacts;
+
+    /** Events started this frame */
+    int32 FrameSpawns;
+
+    /** Local view, captured once per frame */
+    FVector ViewLocation;
+    FVector ViewDirection;
+    float ViewCosHalfAngle;
+    bool bHasView;
+};
@@ -0,0 +1,92 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_DamageSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "OpenTournament.h"
+#include "UR_Character.h"
+#include "UR_HitscanBatchSubsystem.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Victims Resolved"), STAT_OT_DamageVictimsResolved, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Damage Resolve"), STAT_OT_DamageResolve, STATGROUP_OpenTournament);
+
+static TAutoConsoleVariable<int32> CVarDamageCoalescing(
+    TEXT("ot.DamageCoalescing"),
+    1,
+    TEXT("Accumulate damage received by characters, and resolve it once per victim at the end of the frame.\n")
+    TEXT("0: resolve every damage event immediately\n")
+    TEXT("1: coalesce (default)"),
+    ECVF_Default);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_DamageSubsystem::Deinitialize()
+{
+    PendingVictims.Empty();
+    ResolvingVictims.Empty();
+
+    Super::Deinitialize();
+}
+
+bool UUR_DamageSubsystem::IsCoalescingEnabled() const
+{
+    return CVarDamageCoalescing.GetValueOnGameThread() != 0;
+}
+
+void UUR_DamageSubsystem::AddPendingVictim(AUR_Character* Victim)
+{
+    PendingVictims.Add(Victim);
+}
+
+void UUR_DamageSubsystem::Flush()
+{
+    if (PendingVictims.Num() == 0)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_OT_DamageResolve);
+    INC_DWORD_STAT_BY(STAT_OT_DamageVictimsResolved, PendingVictims.Num());
+
+    // Damage dealt while resolving (eg. death triggering an explosion) goes to the next batch
+    Swap(PendingVictims, ResolvingVictims);
+
+    for (const TWeakObjectPtr<AUR_Character>& Victim : ResolvingVictims)
+    {
+        if (AUR_Character* Char = Victim.Get())
+        {
+            Char->ResolvePendingDamage();
+        }
+    }
+
+    ResolvingVictims.Reset();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_DamageSubsystem::Tick(float DeltaTime)
+{
+    // Tick order between tickables is not defined, make sure batched hitscan damage lands this frame
+    if (UUR_HitscanBatchSubsystem* HitscanBatch = GetWorld()->GetSubsystem<UUR_HitscanBatchSubsystem>())
+    {
+        HitscanBatch->Flush();
+    }
+
+    Flush();
+}
+
+ETickableTickType UUR_DamageSubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_DamageSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_DamageSubsystem, STATGROUP_Tickables);
+}
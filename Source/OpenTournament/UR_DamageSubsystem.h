@@ -0,0 +1,68 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_DamageSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AUR_Character;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Resolves damage accumulated by characters during the frame, once per victim, at the end of the frame.
+*
+* Characters accumulate incoming damage per instigator in TakeDamage, and register here on the first hit of the frame.
+* See AUR_Character::ResolvePendingDamage.
+*
+* The hitscan batch is flushed first, so batched shots are resolved within the same frame.
+* Coalescing can be toggled at runtime with ot.DamageCoalescing.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_DamageSubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Whether damage should be accumulated until the end of the frame, rather than resolved immediately.
+    */
+    bool IsCoalescingEnabled() const;
+
+    /**
+    * Register a character which received damage this frame.
+    */
+    void AddPendingVictim(AUR_Character* Victim);
+
+    /**
+    * Resolve damage of all pending victims now.
+    */
+    void Flush();
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    /** Characters which received damage during this frame */
+    TArray<TWeakObjectPtr<AUR_Character>> PendingVictims;
+
+    /** Victims being resolved. Kept around to reuse allocations */
+    TArray<TWeakObjectPtr<AUR_Character>> ResolvingVictims;
+};
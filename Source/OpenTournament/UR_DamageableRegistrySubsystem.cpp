@@ -0,0 +1,361 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_DamageableRegistrySubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/DamageType.h"
+#include "HAL/IConsoleManager.h"
+
+#include "OpenTournament.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Splash Candidates"), STAT_OT_SplashCandidates, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Splash LOS Traces"), STAT_OT_SplashTraces, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damageable Cell Moves"), STAT_OT_DamageableCellMoves, STATGROUP_OpenTournament);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Damageable Actors"), STAT_OT_DamageableActors, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Splash Damage"), STAT_OT_SplashDamage, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Damageable Grid Update"), STAT_OT_DamageableGridUpdate, STATGROUP_OpenTournament);
+
+static TAutoConsoleVariable<int32> CVarSplashBroadphase(
+    TEXT("ot.SplashBroadphase"),
+    1,
+    TEXT("Find splash damage victims in the damageable actors registry.\n")
+    TEXT("0: generic physics overlap (UGameplayStatics::ApplyRadialDamageWithFalloff)\n")
+    TEXT("1: registry (default)"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarDamageableCellSize(
+    TEXT("ot.DamageableCellSize"),
+    1024.f,
+    TEXT("Size of the damageable actors grid cells. Should be in the range of common splash radii."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSplashMinParallel(
+    TEXT("ot.SplashMinParallel"),
+    4,
+    TEXT("Minimum number of line-of-sight traces in a splash before they are dispatched to worker threads."),
+    ECVF_Default);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_DamageableRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    CellSize = FMath::Max(CVarDamageableCellSize.GetValueOnGameThread(), 64.f);
+    QueryPadding = 0.f;
+}
+
+void UUR_DamageableRegistrySubsystem::Deinitialize()
+{
+    Entries.Empty();
+    Cells.Empty();
+
+    Super::Deinitialize();
+}
+
+bool UUR_DamageableRegistrySubsystem::IsBroadphaseEnabled() const
+{
+    return CVarSplashBroadphase.GetValueOnGameThread() != 0;
+}
+
+void UUR_DamageableRegistrySubsystem::Register(AActor* Actor)
+{
+    if (!Actor || GetWorld()->GetNetMode() == NM_Client)
+    {
+        return;
+    }
+
+    for (const FUR_DamageableEntry& Entry : Entries)
+    {
+        if (Entry.Actor == Actor)
+        {
+            return;
+        }
+    }
+
+    FUR_DamageableEntry& Entry = Entries.AddDefaulted_GetRef();
+    Entry.Actor = Actor;
+    Entry.Cell = GetCell(Actor->GetActorLocation());
+    AddToCell(Entry.Cell, Entries.Num() - 1);
+
+    if (const USceneComponent* Root = Actor->GetRootComponent())
+    {
+        QueryPadding = FMath::Max(QueryPadding, Root->Bounds.SphereRadius);
+    }
+}
+
+void UUR_DamageableRegistrySubsystem::Unregister(AActor* Actor)
+{
+    for (int32 i = 0; i < Entries.Num(); i++)
+    {
+        if (Entries[i].Actor == Actor)
+        {
+            RemoveEntry(i);
+            return;
+        }
+    }
+}
+
+FIntVector UUR_DamageableRegistrySubsystem::GetCell(const FVector& Location) const
+{
+    return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UUR_DamageableRegistrySubsystem::AddToCell(const FIntVector& Cell, int32 Index)
+{
+    Cells.FindOrAdd(Cell).Add(Index);
+}
+
+void UUR_DamageableRegistrySubsystem::RemoveFromCell(const FIntVector& Cell, int32 Index)
+{
+    if (TArray<int32>* Indices = Cells.Find(Cell))
+    {
+        Indices->RemoveSingleSwap(Index, false);
+        if (Indices->Num() == 0)
+        {
+            Cells.Remove(Cell);
+        }
+    }
+}
+
+void UUR_DamageableRegistrySubsystem::RemoveEntry(int32 Index)
+{
+    RemoveFromCell(Entries[Index].Cell, Index);
+
+    // Last entry takes the removed slot, fix its index in its cell
+    const int32 LastIndex = Entries.Num() - 1;
+    if (Index != LastIndex)
+    {
+        if (TArray<int32>* Indices = Cells.Find(Entries[LastIndex].Cell))
+        {
+            const int32 Slot = Indices->Find(LastIndex);
+            if (Slot != INDEX_NONE)
+            {
+                (*Indices)[Slot] = Index;
+            }
+        }
+    }
+
+    Entries.RemoveAtSwap(Index, 1, false);
+}
+
+void UUR_DamageableRegistrySubsystem::UpdateCells()
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_DamageableGridUpdate);
+
+    // Rebuild everything if cell size was changed
+    const float NewCellSize = FMath::Max(CVarDamageableCellSize.GetValueOnGameThread(), 64.f);
+    if (NewCellSize != CellSize)
+    {
+        CellSize = NewCellSize;
+        Cells.Reset();
+        for (int32 i = 0; i < Entries.Num(); i++)
+        {
+            if (const AActor* Actor = Entries[i].Actor.Get())
+            {
+                Entries[i].Cell = GetCell(Actor->GetActorLocation());
+            }
+            AddToCell(Entries[i].Cell, i);
+        }
+    }
+
+    float MaxExtent = 0.f;
+    float MaxSpeed = 0.f;
+
+    // Backwards, RemoveEntry swaps the last entry in
+    for (int32 i = Entries.Num() - 1; i >= 0; i--)
+    {
+        const AActor* Actor = Entries[i].Actor.Get();
+        if (!Actor || Actor->IsPendingKill())
+        {
+            RemoveEntry(i);
+            continue;
+        }
+
+        const FIntVector Cell = GetCell(Actor->GetActorLocation());
+        if (Cell != Entries[i].Cell)
+        {
+            RemoveFromCell(Entries[i].Cell, i);
+            AddToCell(Cell, i);
+            Entries[i].Cell = Cell;
+            INC_DWORD_STAT(STAT_OT_DamageableCellMoves);
+        }
+
+        if (const USceneComponent* Root = Actor->GetRootComponent())
+        {
+            MaxExtent = FMath::Max(MaxExtent, Root->Bounds.SphereRadius);
+        }
+        MaxSpeed = FMath::Max(MaxSpeed, Actor->GetVelocity().Size());
+    }
+
+    // Actors keep moving until the next update
+    QueryPadding = MaxExtent + MaxSpeed * GetWorld()->GetDeltaSeconds();
+
+    SET_DWORD_STAT(STAT_OT_DamageableActors, Entries.Num());
+}
+
+void UUR_DamageableRegistrySubsystem::GatherCandidates(const FVector& Origin, float Radius, TArray<AActor*>& OutActors) const
+{
+    const float QueryRadius = Radius + QueryPadding;
+    const FIntVector MinCell = GetCell(Origin - FVector(QueryRadius));
+    const FIntVector MaxCell = GetCell(Origin + FVector(QueryRadius));
+
+    const auto GatherCell = [this, &OutActors](const TArray<int32>& Indices)
+    {
+        for (const int32 Index : Indices)
+        {
+            if (AActor* Actor = Entries[Index].Actor.Get())
+            {
+                OutActors.Add(Actor);
+            }
+        }
+    };
+
+    const int64 NumQueryCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+    if (NumQueryCells > Cells.Num())
+    {
+        // Huge radius, cheaper to walk occupied cells
+        for (const auto& Pair : Cells)
+        {
+            const FIntVector& Cell = Pair.Key;
+            if (Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y && Cell.Z >= MinCell.Z && Cell.Z <= MaxCell.Z)
+            {
+                GatherCell(Pair.Value);
+            }
+        }
+        return;
+    }
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+        {
+            for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+            {
+                if (const TArray<int32>* Indices = Cells.Find(FIntVector(X, Y, Z)))
+                {
+                    GatherCell(*Indices);
+                }
+            }
+        }
+    }
+}
+
+bool UUR_DamageableRegistrySubsystem::ApplyRadialDamageWithFalloff(float BaseDamage, float MinimumDamage, const FVector& Origin, float DamageInnerRadius, float DamageOuterRadius, float DamageFalloff, TSubclassOf<UDamageType> DamageTypeClass, const TArray<AActor*>& IgnoreActors, AActor* DamageCauser, AController* InstigatedByController, ECollisionChannel DamagePreventionChannel)
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_SplashDamage);
+
+    TArray<AActor*> Candidates;
+    GatherCandidates(Origin, DamageOuterRadius, Candidates);
+    INC_DWORD_STAT_BY(STAT_OT_SplashCandidates, Candidates.Num());
+
+    // Narrow down to primitives actually in the radius, grouped by victim
+    const float RadiusSq = FMath::Square(DamageOuterRadius);
+    TArray<FUR_SplashTarget, TInlineAllocator<16>> Targets;
+    for (AActor* Victim : Candidates)
+    {
+        if (Victim == DamageCauser || IgnoreActors.Contains(Victim))
+        {
+            continue;
+        }
+
+        TInlineComponentArray<UPrimitiveComponent*> Primitives(Victim);
+        for (UPrimitiveComponent* Primitive : Primitives)
+        {
+            if (Primitive->IsQueryCollisionEnabled() && Primitive->Bounds.GetBox().ComputeSquaredDistanceToPoint(Origin) <= RadiusSq)
+            {
+                FUR_SplashTarget& Target = Targets.AddDefaulted_GetRef();
+                Target.Victim = Victim;
+                Target.Component = Primitive;
+                Target.bVisible = false;
+            }
+        }
+    }
+
+    if (Targets.Num() == 0)
+    {
+        return false;
+    }
+
+    INC_DWORD_STAT_BY(STAT_OT_SplashTraces, Targets.Num());
+
+    // Line-of-sight, same rules as UGameplayStatics
+    const UWorld* World = GetWorld();
+    FCollisionQueryParams LineParams(SCENE_QUERY_STAT(ComponentIsVisibleFrom), true, DamageCauser);
+    LineParams.AddIgnoredActors(IgnoreActors);
+
+    ParallelFor(Targets.Num(), [World, &Origin, &LineParams, &Targets, DamagePreventionChannel](int32 i)
+    {
+        FUR_SplashTarget& Target = Targets[i];
+        const FVector TraceEnd = Target.Component->Bounds.Origin;
+        if (World->LineTraceSingleByChannel(Target.Hit, Origin, TraceEnd, DamagePreventionChannel, LineParams))
+        {
+            Target.bVisible = (Target.Hit.Component.Get() == Target.Component);
+        }
+        else
+        {
+            // Nothing blocking, victim is visible
+            const FVector FakeHitLoc = Target.Component->GetComponentLocation();
+            Target.Hit = FHitResult(Target.Victim, Target.Component, FakeHitLoc, (Origin - FakeHitLoc).GetSafeNormal());
+            Target.bVisible = true;
+        }
+    }, Targets.Num() < CVarSplashMinParallel.GetValueOnGameThread());
+
+    // Damage, one event per victim with all its visible components
+    const TSubclassOf<UDamageType> ValidDamageTypeClass = DamageTypeClass ? DamageTypeClass : TSubclassOf<UDamageType>(UDamageType::StaticClass());
+    bool bAppliedDamage = false;
+
+    int32 Start = 0;
+    while (Start < Targets.Num())
+    {
+        AActor* Victim = Targets[Start].Victim;
+
+        FRadialDamageEvent DmgEvent;
+        int32 End = Start;
+        for (; End < Targets.Num() && Targets[End].Victim == Victim; End++)
+        {
+            if (Targets[End].bVisible)
+            {
+                DmgEvent.ComponentHits.Add(Targets[End].Hit);
+            }
+        }
+
+        if (DmgEvent.ComponentHits.Num() > 0 && !Victim->IsPendingKill())
+        {
+            DmgEvent.DamageTypeClass = ValidDamageTypeClass;
+            DmgEvent.Origin = Origin;
+            DmgEvent.Params = FRadialDamageParams(BaseDamage, MinimumDamage, DamageInnerRadius, DamageOuterRadius, DamageFalloff);
+
+            Victim->TakeDamage(BaseDamage, DmgEvent, InstigatedByController, DamageCauser);
+            bAppliedDamage = true;
+        }
+
+        Start = End;
+    }
+
+    return bAppliedDamage;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_DamageableRegistrySubsystem::Tick(float DeltaTime)
+{
+    UpdateCells();
+}
+
+ETickableTickType UUR_DamageableRegistrySubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_DamageableRegistrySubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_DamageableRegistrySubsystem, STATGROUP_Tickables);
+}
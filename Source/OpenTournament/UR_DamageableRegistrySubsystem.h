@@ -0,0 +1,141 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_DamageableRegistrySubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AActor;
+class AController;
+class UDamageType;
+class UPrimitiveComponent;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* A registered damageable actor.
+*/
+struct FUR_DamageableEntry
+{
+    TWeakObjectPtr<AActor> Actor;
+
+    /** Grid cell the actor is currently indexed in */
+    FIntVector Cell;
+};
+
+/**
+* A primitive of a splash victim waiting for its line-of-sight trace.
+*/
+struct FUR_SplashTarget
+{
+    AActor* Victim;
+
+    UPrimitiveComponent* Component;
+
+    /** Filled in by the trace */
+    FHitResult Hit;
+
+    bool bVisible;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Authority registry of actors that can take damage, indexed by a uniform spatial hash.
+*
+* Actors register themselves (see AUR_Character::BeginPlay) and are moved between grid cells incrementally,
+* once per frame, only when they change cell.
+*
+* Splash damage uses the grid as broadphase instead of a generic physics overlap,
+* so pickups, projectiles and world geometry in the radius are never considered.
+* Line-of-sight to all candidates is then traced in one parallel batch,
+* and damage goes through the regular FRadialDamageEvent falloff in AActor::TakeDamage.
+*
+* Actors which are not registered do not receive splash damage while the broadphase is enabled.
+* It can be toggled at runtime with ot.SplashBroadphase.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_DamageableRegistrySubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /**
+    * Whether splash damage should use this registry, rather than UGameplayStatics.
+    */
+    bool IsBroadphaseEnabled() const;
+
+    /**
+    * Add an actor to the registry. Does nothing on clients.
+    */
+    void Register(AActor* Actor);
+
+    /**
+    * Remove an actor from the registry.
+    */
+    void Unregister(AActor* Actor);
+
+    /**
+    * Gather registered actors which may be within Radius of Origin.
+    * This is a broadphase only, candidates need to be checked against their actual bounds.
+    */
+    void GatherCandidates(const FVector& Origin, float Radius, TArray<AActor*>& OutActors) const;
+
+    /**
+    * Equivalent of UGameplayStatics::ApplyRadialDamageWithFalloff, using the registry as broadphase.
+    * Returns true if damage was applied to at least one actor.
+    */
+    bool ApplyRadialDamageWithFalloff(float BaseDamage, float MinimumDamage, const FVector& Origin, float DamageInnerRadius, float DamageOuterRadius, float DamageFalloff, TSubclassOf<UDamageType> DamageTypeClass, const TArray<AActor*>& IgnoreActors, AActor* DamageCauser, AController* InstigatedByController, ECollisionChannel DamagePreventionChannel);
+
+    /**
+    * Move actors which changed cell since last update.
+    */
+    void UpdateCells();
+
+    FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    FIntVector GetCell(const FVector& Location) const;
+
+    void AddToCell(const FIntVector& Cell, int32 Index);
+
+    void RemoveFromCell(const FIntVector& Cell, int32 Index);
+
+    void RemoveEntry(int32 Index);
+
+    TArray<FUR_DamageableEntry> Entries;
+
+    /** Entry indices per occupied cell */
+    TMap<FIntVector, TArray<int32>> Cells;
+
+    /** Cell size the grid was built with */
+    float CellSize;
+
+    /**
+    * Distance added to queries, covering the extent of registered actors
+    * and how far they may have moved since their cell was updated.
+    */
+    float QueryPadding;
+};
@@ -14,6 +14,39 @@ void UUR_FireModeBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
     DOREPLIFETIME_CONDITION(UUR_FireModeBase, bIsSpinningUpRep, COND_SkipOwner);
 }
 
+/** Name of data objects created from deprecated inline Content */
+static const FName MigratedFireModeDataName(TEXT("MigratedFireModeData"));
+
+void UUR_FireModeBase::PostLoad()
+{
+    Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+    // Templates without data get their own, filled with their former inline Content.
+    // Native default data (class defaults of a data class) and data migrated by a parent template
+    // are inherited as well, but do not hold our overrides.
+    const bool bNativeDefaultData = FireModeData && FireModeData->HasAnyFlags(RF_ClassDefaultObject);
+    const bool bInheritedMigratedData = FireModeData && FireModeData->GetOuter() != this && FireModeData->GetFName() == MigratedFireModeDataName;
+    if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) && (!FireModeData || bNativeDefaultData || bInheritedMigratedData))
+    {
+        const TSubclassOf<UUR_FireModeData> DataClass = bNativeDefaultData ? FireModeData->GetClass() : GetFireModeDataClass();
+        UUR_FireModeData* Data = NewObject<UUR_FireModeData>(this, DataClass, MigratedFireModeDataName, RF_Public | RF_Transactional);
+        CopyDeprecatedContent(Data);
+        FireModeData = Data;
+    }
+#endif
+}
+
+#if WITH_EDITORONLY_DATA
+void UUR_FireModeBase::CopyDeprecatedContent(UUR_FireModeData* Data) const
+{
+    Data->InitialAmmoCost = InitialAmmoCost_DEPRECATED;
+    Data->Spread = Spread_DEPRECATED;
+    Data->MuzzleSocketName = MuzzleSocketName_DEPRECATED;
+    Data->MuzzleFlashTemplate = MuzzleFlashTemplate_DEPRECATED;
+}
+#endif
+
 void UUR_FireModeBase::SetBusy(bool bNewBusy)
 {
     if (bNewBusy != bIsBusy)
@@ -292,6 +325,21 @@ float UUR_FireModeBase::GetCooldownStartTime_Implementation()
     return 0.f;
 }
 
+void UUR_FireModeBase::ResetFireMode()
+{
+    FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+    TimerManager.ClearTimer(SpinUpTimerHandle);
+    TimerManager.ClearTimer(SpinDownIdleTimerHandle);
+    TimerManager.ClearTimer(SpinDownTimerHandle);
+    TimerManager.ClearTimer(DelayedSpinUpTimerHandle);
+
+    bRequestedFire = false;
+    bRequestedIdle = false;
+    bIsBusy = false;
+    bFullySpinnedUp = false;
+    bIsSpinningUpRep = false;
+}
+
 
 //============================================================
 // UActorComponent tweaks
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "UR_FireModeData.h"
 #include "UR_FireModeBase.generated.h"
 
 class UFXSystemAsset;
@@ -34,8 +35,13 @@ public:
         SpinDownTime = 0.f;
         IdleAtSpinPercent = 1.f;
 
-        InitialAmmoCost = 1;
-        MuzzleSocketName = FName(TEXT("Muzzle"));
+        FireModeData = nullptr;
+#if WITH_EDITORONLY_DATA
+        InitialAmmoCost_DEPRECATED = 1;
+        Spread_DEPRECATED = 0.f;
+        MuzzleSocketName_DEPRECATED = FName(TEXT("Muzzle"));
+        MuzzleFlashTemplate_DEPRECATED = nullptr;
+#endif
     }
 
     /**
@@ -85,23 +91,57 @@ public:
     * method can still be overriden by the implementer.
     * If methods are overriden, then it's up to the implementer to use, or not,
     * these "Content" properties in whatever way they want.
+    *
+    * Content is stored in a shared FireModeData asset, so all instances of a weapon point to the same data.
+    * Read it through the getters.
+    */
+
+    /**
+    * Shared content of this fire mode. Must match the fire mode type (eg. UUR_FireModeBasicData for FireModeBasic).
+    * When not set, the defaults of the data class are used.
     */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content", Meta = (DisplayPriority = "1"))
+    UUR_FireModeData* FireModeData;
 
+#if WITH_EDITORONLY_DATA
     /**
-    * Minimum necessary ammo for weapon to allow firing this firemode at all.
-    * If weapon ammo is below that value, it should click as out-of-ammo.
+    * Former inline Content, only loaded to be migrated into FireModeData. See PostLoad.
     */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content")
-    int32 InitialAmmoCost;
+    UPROPERTY()
+    int32 InitialAmmoCost_DEPRECATED;
+
+    UPROPERTY()
+    float Spread_DEPRECATED;
+
+    UPROPERTY()
+    FName MuzzleSocketName_DEPRECATED;
+
+    UPROPERTY()
+    UFXSystemAsset* MuzzleFlashTemplate_DEPRECATED;
+#endif
 
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content")
-    float Spread;
+    FORCEINLINE const UUR_FireModeData* GetFireModeData() const { return FireModeData ? FireModeData : GetDefault<UUR_FireModeData>(); }
 
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content")
-    FName MuzzleSocketName;
+    virtual int32 GetInitialAmmoCost() const { return GetFireModeData()->InitialAmmoCost; }
+    FORCEINLINE float GetSpread() const { return GetFireModeData()->Spread; }
+    FORCEINLINE FName GetMuzzleSocketName() const { return GetFireModeData()->MuzzleSocketName; }
+    FORCEINLINE UFXSystemAsset* GetMuzzleFlashTemplate() const { return GetFireModeData()->MuzzleFlashTemplate; }
 
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content")
-    UFXSystemAsset* MuzzleFlashTemplate;
+    virtual void PostLoad() override;
+
+protected:
+
+#if WITH_EDITORONLY_DATA
+    /**
+    * Data class matching this fire mode type, created when migrating the deprecated inline Content.
+    */
+    virtual TSubclassOf<UUR_FireModeData> GetFireModeDataClass() const { return UUR_FireModeData::StaticClass(); }
+
+    /**
+    * Copy the deprecated inline Content into Data. Subclasses copy their own after calling Super.
+    */
+    virtual void CopyDeprecatedContent(UUR_FireModeData* Data) const;
+#endif
 
 public:
 
@@ -185,6 +225,12 @@ public:
     UFUNCTION(BlueprintPure)
     virtual float GetCurrentSpinUpValue();
 
+    /**
+    * Drop all runtime state (spin, busy, cooldown, charge...) so the firemode behaves as freshly spawned.
+    * Used when a weapon is recycled for a new owner instead of being respawned.
+    */
+    virtual void ResetFireMode();
+
 protected:
 
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
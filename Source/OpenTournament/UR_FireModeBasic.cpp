@@ -2,8 +2,188 @@
 
 #include "UR_FireModeBasic.h"
 
+#include "Engine/NetSerialization.h"
 #include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
 #include "TimerManager.h"
+#include "UObject/CoreNet.h"
+
+#include "UR_FireSchedulerSubsystem.h"
+#include "UR_ProjectilePredictionSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Misc/AutomationTest.h"
+#endif
+
+//============================================================
+// Shot info serialization
+//============================================================
+
+/**
+* Whether vectors fit the standard [Location, Direction] layout.
+* Direction must be a unit vector (or zero) to be packed as a normal.
+*/
+static bool IsStandardShotLayout(const TArray<FVector>& Vectors)
+{
+    return Vectors.Num() == 2 && (Vectors[1].IsNearlyZero() || Vectors[1].IsNormalized());
+}
+
+/**
+* Serialize shot vectors, either in the compact standard layout or as a full precision array.
+*/
+static void SerializeShotVectors(FArchive& Ar, TArray<FVector>& Vectors, bool bStandard, bool& bOutSuccess)
+{
+    if (bStandard)
+    {
+        if (Ar.IsLoading())
+        {
+            Vectors.SetNumZeroed(2);
+        }
+        bOutSuccess &= SerializePackedVector<10, 24>(Vectors[0], Ar);
+        bOutSuccess &= SerializeFixedVector<1, 16>(Vectors[1], Ar);
+    }
+    else
+    {
+        uint32 Num = Vectors.Num();
+        Ar.SerializeIntPacked(Num);
+        if (Ar.IsLoading())
+        {
+            // Don't trust incoming data with allocations
+            if (Num > 64)
+            {
+                Ar.SetError();
+                bOutSuccess = false;
+                return;
+            }
+            Vectors.SetNumZeroed(Num);
+        }
+        for (FVector& Vector : Vectors)
+        {
+            Ar << Vector;
+        }
+    }
+}
+
+bool FSimulatedShotInfo::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    bOutSuccess = true;
+
+    uint8 bStandard = IsStandardShotLayout(Vectors) && Actors.Num() == 0;
+    uint8 bHasSeed = (Seed != 0);
+    uint8 bHasShotId = (ShotId != 0);
+    Ar.SerializeBits(&bStandard, 1);
+    Ar.SerializeBits(&bHasSeed, 1);
+    Ar.SerializeBits(&bHasShotId, 1);
+
+    SerializeShotVectors(Ar, Vectors, bStandard != 0, bOutSuccess);
+
+    if (bStandard)
+    {
+        if (Ar.IsLoading())
+        {
+            Actors.Reset();
+        }
+    }
+    else if (bOutSuccess)
+    {
+        uint32 NumActors = Actors.Num();
+        Ar.SerializeIntPacked(NumActors);
+        if (Ar.IsLoading())
+        {
+            if (NumActors > 64)
+            {
+                Ar.SetError();
+                bOutSuccess = false;
+                return true;
+            }
+            Actors.SetNumZeroed(NumActors);
+        }
+        for (AActor*& Actor : Actors)
+        {
+            UObject* Obj = Actor;
+            bOutSuccess &= Map && Map->SerializeObject(Ar, AActor::StaticClass(), Obj);
+            Actor = Cast<AActor>(Obj);
+        }
+    }
+
+    if (bHasSeed)
+    {
+        Ar << Seed;
+    }
+    else if (Ar.IsLoading())
+    {
+        Seed = 0;
+    }
+
+    if (bHasShotId)
+    {
+        Ar << ShotId;
+    }
+    else if (Ar.IsLoading())
+    {
+        ShotId = 0;
+    }
+
+    Ar << ClientTime;
+
+    return true;
+}
+
+bool FHitscanVisualInfo::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    bOutSuccess = true;
+
+    uint8 bStandard = IsStandardShotLayout(Vectors);
+    uint8 bHasSeed = (Seed != 0);
+    Ar.SerializeBits(&bStandard, 1);
+    Ar.SerializeBits(&bHasSeed, 1);
+
+    SerializeShotVectors(Ar, Vectors, bStandard != 0, bOutSuccess);
+
+    if (bHasSeed)
+    {
+        Ar << Seed;
+    }
+    else if (Ar.IsLoading())
+    {
+        Seed = 0;
+    }
+
+    return true;
+}
+
+//============================================================
+// FireModeBasic
+//============================================================
+
+#if WITH_EDITORONLY_DATA
+void UUR_FireModeBasic::CopyDeprecatedContent(UUR_FireModeData* Data) const
+{
+    Super::CopyDeprecatedContent(Data);
+
+    if (UUR_FireModeBasicData* BasicData = Cast<UUR_FireModeBasicData>(Data))
+    {
+        BasicData->FireInterval = FireInterval_DEPRECATED;
+        BasicData->FireSound = FireSound_DEPRECATED;
+        BasicData->ProjectileClass = ProjectileClass_DEPRECATED;
+        BasicData->bPredictProjectile = bPredictProjectile_DEPRECATED;
+        BasicData->HitscanTraceDistance = HitscanTraceDistance_DEPRECATED;
+        BasicData->HitscanDamage = HitscanDamage_DEPRECATED;
+        BasicData->HitscanDamageType = HitscanDamageType_DEPRECATED;
+        BasicData->BeamTemplate = BeamTemplate_DEPRECATED;
+        BasicData->BeamVectorParamName = BeamVectorParamName_DEPRECATED;
+        BasicData->bUseTracerRenderer = bUseTracerRenderer_DEPRECATED;
+        BasicData->TracerMesh = TracerMesh_DEPRECATED;
+        BasicData->TracerMaterial = TracerMaterial_DEPRECATED;
+        BasicData->TracerColor = TracerColor_DEPRECATED;
+        BasicData->TracerWidth = TracerWidth_DEPRECATED;
+        BasicData->TracerLifeTime = TracerLifeTime_DEPRECATED;
+        BasicData->BeamImpactTemplate = BeamImpactTemplate_DEPRECATED;
+        BasicData->BeamImpactSound = BeamImpactSound_DEPRECATED;
+    }
+}
+#endif
 
 void UUR_FireModeBasic::StartFire_Implementation()
 {
@@ -13,7 +193,7 @@ void UUR_FireModeBasic::StartFire_Implementation()
         // FireModeBasic shots are all individually initiated by client (or the fire requester).
         return;
     }
-    if (GetWorld()->GetTimerManager().GetTimerRemaining(CooldownTimerHandle) > 0.f)
+    if (GetCooldownRemaining() > 0.f)
     {
         return; // fire loop is already active
     }
@@ -22,6 +202,11 @@ void UUR_FireModeBasic::StartFire_Implementation()
 
     FSimulatedShotInfo SimulatedInfo;
 
+    if (AGameStateBase* GS = GetWorld()->GetGameState())
+    {
+        SimulatedInfo.ClientTime = GS->GetServerWorldTimeSeconds();
+    }
+
     if (BasicInterface)
     {
         IUR_FireModeBasicInterface::Execute_PlayFireEffects(BasicInterface.GetObject(), this);
@@ -34,6 +219,12 @@ void UUR_FireModeBasic::StartFire_Implementation()
         }
         else
         {
+            if (ShouldPredictProjectile() && GetProjectileClass() && GetNetMode() == NM_Client)
+            {
+                // Zero means not predicted
+                LastShotId = (LastShotId == MAX_uint8) ? 1 : LastShotId + 1;
+                SimulatedInfo.ShotId = LastShotId;
+            }
             IUR_FireModeBasicInterface::Execute_SimulateShot(BasicInterface.GetObject(), this, SimulatedInfo);
         }
     }
@@ -41,7 +232,7 @@ void UUR_FireModeBasic::StartFire_Implementation()
     if (GetNetMode() == NM_Client)
     {
         LocalFireTime = GetWorld()->GetTimeSeconds();
-        GetWorld()->GetTimerManager().SetTimer(CooldownTimerHandle, this, &UUR_FireModeBasic::CooldownTimer, FMath::Max(FireInterval, 0.001f), false);
+        SetCooldown(GetFireInterval());
     }
 
     ServerFire(SimulatedInfo);
@@ -68,7 +259,7 @@ float UUR_FireModeBasic::GetTimeUntilIdle_Implementation()
     {
         return FMath::Max(
             Super::GetTimeUntilIdle_Implementation(),
-            GetWorld()->GetTimerManager().GetTimerRemaining(CooldownTimerHandle)
+            GetCooldownRemaining()
         );
     }
     return 0.f;
@@ -76,14 +267,14 @@ float UUR_FireModeBasic::GetTimeUntilIdle_Implementation()
 
 float UUR_FireModeBasic::GetCooldownStartTime_Implementation()
 {
-    // Use either CooldownTimerHandle or SpinDownIdleTimerHandle depending on which will trigger LAST.
-    if (GetWorld()->GetTimerManager().GetTimerRemaining(SpinDownIdleTimerHandle) > GetWorld()->GetTimerManager().GetTimerRemaining(CooldownTimerHandle))
+    // Use either cooldown or SpinDownIdleTimerHandle depending on which will trigger LAST.
+    if (GetWorld()->GetTimerManager().GetTimerRemaining(SpinDownIdleTimerHandle) > GetCooldownRemaining())
     {
         return Super::GetCooldownStartTime_Implementation();
     }
-    else if ( GetWorld()->GetTimerManager().TimerExists(CooldownTimerHandle))
+    else if (IsCooldownActive())
     {
-        return GetWorld()->GetTimeSeconds() - GetWorld()->GetTimerManager().GetTimerElapsed(CooldownTimerHandle);
+        return CooldownStartTime;
     }
     return 0.f;
 }
@@ -98,7 +289,7 @@ void UUR_FireModeBasic::ServerFire_Implementation(const FSimulatedShotInfo& Simu
         // We only need to check internal spinup and cooldown timers.
         if (bFullySpinnedUp)
         {
-            Delay = GetWorld()->GetTimerManager().GetTimerRemaining(CooldownTimerHandle);
+            Delay = GetCooldownRemaining();
         }
         else if (GetWorld()->GetTimerManager().IsTimerActive(SpinUpTimerHandle))
         {
@@ -122,19 +313,19 @@ void UUR_FireModeBasic::ServerFire_Implementation(const FSimulatedShotInfo& Simu
     {
         UE_LOG(LogWeapon, Log, TEXT("ServerFire Delay = %f"), Delay);
 
-        if (Delay > FMath::Min(0.200f, FireInterval / 2.f))
+        if (Delay > FMath::Min(0.200f, GetFireInterval() / 2.f))
         {
             // Too much delay, discard this shot
+            if (SimulatedInfo.ShotId != 0)
+            {
+                ClientRejectShot(SimulatedInfo.ShotId);
+            }
             return;
         }
 
         // Delay a bit and fire
-        FTimerDelegate Callback;
-        Callback.BindLambda([this, SimulatedInfo]
-        {
-            ServerFire_Implementation(SimulatedInfo);
-        });
-        GetWorld()->GetTimerManager().SetTimer(DelayedFireTimerHandle, Callback, Delay, false);
+        DelayedShotInfo = SimulatedInfo;
+        ScheduleDelayedFire(Delay);
         return;
     }
 
@@ -152,7 +343,11 @@ void UUR_FireModeBasic::AuthorityShot(const FSimulatedShotInfo& SimulatedInfo)
         {
             IUR_FireModeBasicInterface::Execute_AuthorityHitscanShot(BasicInterface.GetObject(), this, SimulatedInfo, HitscanInfo);
         }
-        MulticastFiredHitscan(HitscanInfo);
+        // Empty info means resolution was deferred (eg. batched hitscan), see AuthorityHitscanShotResolved
+        if (HitscanInfo.Vectors.Num() > 0)
+        {
+            MulticastFiredHitscan(HitscanInfo);
+        }
     }
     else
     {
@@ -163,7 +358,23 @@ void UUR_FireModeBasic::AuthorityShot(const FSimulatedShotInfo& SimulatedInfo)
         MulticastFired();
     }
 
-    GetWorld()->GetTimerManager().SetTimer(CooldownTimerHandle, this, &UUR_FireModeBasic::CooldownTimer, FMath::Max(FireInterval, 0.001f), false);
+    SetCooldown(GetFireInterval());
+}
+
+void UUR_FireModeBasic::ClientRejectShot_Implementation(uint8 ShotId)
+{
+    // Fake projectiles are spawned with the same instigator as AUR_Weapon::SpawnProjectile
+    AActor* Weapon = GetOwner();
+    APawn* Shooter = Weapon ? (Weapon->GetInstigator() ? Weapon->GetInstigator() : Cast<APawn>(Weapon->GetOwner())) : nullptr;
+    if (UUR_ProjectilePredictionSubsystem* Prediction = GetWorld()->GetSubsystem<UUR_ProjectilePredictionSubsystem>())
+    {
+        Prediction->RejectShot(Shooter, ShotId);
+    }
+}
+
+void UUR_FireModeBasic::AuthorityHitscanShotResolved(const FHitscanVisualInfo& HitscanInfo)
+{
+    MulticastFiredHitscan(HitscanInfo);
 }
 
 void UUR_FireModeBasic::MulticastFired_Implementation()
@@ -178,7 +389,7 @@ void UUR_FireModeBasic::MulticastFired_Implementation()
         {
             // Set busy+cooldown on remote clients as well so they can track state accurately
             SetBusy(true);
-            GetWorld()->GetTimerManager().SetTimer(CooldownTimerHandle, this, &UUR_FireModeBasic::CooldownTimer, FMath::Max(FireInterval, 0.001f), false);
+            SetCooldown(GetFireInterval());
             // Remote clients visual callback
             if (BasicInterface)
             {
@@ -200,7 +411,7 @@ void UUR_FireModeBasic::MulticastFiredHitscan_Implementation(const FHitscanVisua
         {
             // Set busy+cooldown on remote clients as well so they can track state accurately
             SetBusy(true);
-            GetWorld()->GetTimerManager().SetTimer(CooldownTimerHandle, this, &UUR_FireModeBasic::CooldownTimer, FMath::Max(FireInterval, 0.001f), false);
+            SetCooldown(GetFireInterval());
             // Remote clients visual callbacks
             if (BasicInterface)
             {
@@ -217,13 +428,215 @@ void UUR_FireModeBasic::LocalConfirmFired()
     if (bIsBusy)
     {
         float FirePing = GetWorld()->TimeSince(LocalFireTime);
-        float Delay = FireInterval - FirePing / 2.f;
+        float Delay = GetFireInterval() - FirePing / 2.f;
         if (Delay > 0.f)
         {
-            GetWorld()->GetTimerManager().SetTimer(CooldownTimerHandle, this, &UUR_FireModeBasic::CooldownTimer, Delay, false);
+            SetCooldownEndTime(GetWorld()->GetTimeSeconds() + Delay);
         }
     }
 
     // Don't keep this var around
     LocalFireTime = 0.f;
 }
+
+
+//============================================================
+// Scheduling
+//============================================================
+
+UUR_FireSchedulerSubsystem* UUR_FireModeBasic::GetFireScheduler() const
+{
+    return GetWorld() ? GetWorld()->GetSubsystem<UUR_FireSchedulerSubsystem>() : nullptr;
+}
+
+void UUR_FireModeBasic::ResetFireMode()
+{
+    Super::ResetFireMode();
+
+    if (UUR_FireSchedulerSubsystem* Scheduler = GetFireScheduler())
+    {
+        Scheduler->Cancel(this, EUR_FireScheduleEvent::Cooldown);
+        Scheduler->Cancel(this, EUR_FireScheduleEvent::DelayedFire);
+    }
+    CooldownStartTime = 0.f;
+    CooldownEndTime = 0.f;
+    ChainedFireTime = 0.f;
+    LocalFireTime = 0.f;
+}
+
+void UUR_FireModeBasic::SetCooldown(float Duration)
+{
+    CooldownStartTime = (ChainedFireTime > 0.f) ? ChainedFireTime : GetWorld()->GetTimeSeconds();
+    SetCooldownEndTime(CooldownStartTime + FMath::Max(Duration, 0.001f));
+}
+
+void UUR_FireModeBasic::SetCooldownEndTime(float EndTime)
+{
+    CooldownEndTime = EndTime;
+    if (UUR_FireSchedulerSubsystem* Scheduler = GetFireScheduler())
+    {
+        Scheduler->Schedule(this, EUR_FireScheduleEvent::Cooldown, EndTime);
+    }
+}
+
+float UUR_FireModeBasic::GetCooldownRemaining() const
+{
+    return IsCooldownActive() ? FMath::Max(CooldownEndTime - GetWorld()->GetTimeSeconds(), 0.f) : 0.f;
+}
+
+void UUR_FireModeBasic::ScheduleDelayedFire(float Delay)
+{
+    if (UUR_FireSchedulerSubsystem* Scheduler = GetFireScheduler())
+    {
+        Scheduler->Schedule(this, EUR_FireScheduleEvent::DelayedFire, GetWorld()->GetTimeSeconds() + Delay);
+    }
+}
+
+void UUR_FireModeBasic::DelayedFireCallback()
+{
+    ServerFire_Implementation(DelayedShotInfo);
+}
+
+void UUR_FireModeBasic::OnScheduledEvent(EUR_FireScheduleEvent Event, float DueTime)
+{
+    switch (Event)
+    {
+    case EUR_FireScheduleEvent::Cooldown:
+        if (DueTime != CooldownEndTime)
+        {
+            // Stale, cooldown was restarted or moved since
+            break;
+        }
+        CooldownEndTime = 0.f;
+        // Only chain when refiring right away. If we stayed idle, next shot starts from current time.
+        ChainedFireTime = DueTime;
+        CooldownTimer();
+        ChainedFireTime = 0.f;
+        break;
+
+    case EUR_FireScheduleEvent::DelayedFire:
+        DelayedFireCallback();
+        break;
+    }
+}
+
+
+//============================================================
+// Tests
+//============================================================
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOpenTournamentShotInfoNetSerializeTest, "OpenTournament.Feature.Weapons.ShotInfoNetSerialize", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+* Compares the size of the compact layout against the generic one, and checks round trip precision.
+* No package map, so no actors involved.
+*/
+bool FOpenTournamentShotInfoNetSerializeTest::RunTest(const FString& Parameters)
+{
+    FSimulatedShotInfo Shot;
+    Shot.Vectors.Add(FVector(1234.567f, -4321.123f, 256.789f));
+    Shot.Vectors.Add(FRotator(-12.f, 73.f, 0.f).Vector());
+    Shot.Seed = 0x12345678;
+    Shot.ClientTime = 123.456f;
+    Shot.ShotId = 42;
+
+    // Same shot, with a third vector to force the generic layout
+    FSimulatedShotInfo GenericShot = Shot;
+    GenericShot.Vectors.Add(FVector::ZeroVector);
+
+    bool bSuccess;
+
+    FNetBitWriter CompactWriter(nullptr, 0);
+    Shot.NetSerialize(CompactWriter, nullptr, bSuccess);
+    TestTrue(TEXT("Compact serialization succeeded"), bSuccess && !CompactWriter.IsError());
+
+    FNetBitWriter GenericWriter(nullptr, 0);
+    GenericShot.NetSerialize(GenericWriter, nullptr, bSuccess);
+    TestTrue(TEXT("Generic serialization succeeded"), bSuccess && !GenericWriter.IsError());
+
+    // Generic layout minus the extra vector, for a fair comparison
+    const int64 CompactBits = CompactWriter.GetNumBits();
+    const int64 GenericBits = GenericWriter.GetNumBits() - 3 * 32;
+    AddInfo(FString::Printf(TEXT("FSimulatedShotInfo : compact %lld bits, generic %lld bits"), CompactBits, GenericBits));
+    TestTrue(TEXT("Compact layout is smaller"), CompactBits < GenericBits);
+
+    FNetBitReader Reader(nullptr, CompactWriter.GetData(), CompactWriter.GetNumBits());
+    FSimulatedShotInfo Received;
+    Received.NetSerialize(Reader, nullptr, bSuccess);
+    TestTrue(TEXT("Deserialization succeeded"), bSuccess && !Reader.IsError());
+    TestEqual(TEXT("Vectors count"), Received.Vectors.Num(), 2);
+    if (Received.Vectors.Num() == 2)
+    {
+        TestTrue(TEXT("Location within 0.1"), Received.Vectors[0].Equals(Shot.Vectors[0], 0.1f));
+        TestTrue(TEXT("Direction within 0.001"), Received.Vectors[1].Equals(Shot.Vectors[1], 0.001f));
+    }
+    TestEqual(TEXT("Seed"), Received.Seed, Shot.Seed);
+    TestEqual(TEXT("ClientTime"), Received.ClientTime, Shot.ClientTime);
+    TestEqual(TEXT("ShotId"), Received.ShotId, Shot.ShotId);
+
+    FHitscanVisualInfo Visual;
+    Visual.Vectors.Add(Shot.Vectors[0]);
+    Visual.Vectors.Add(FVector::UpVector);
+
+    FNetBitWriter VisualWriter(nullptr, 0);
+    Visual.NetSerialize(VisualWriter, nullptr, bSuccess);
+    AddInfo(FString::Printf(TEXT("FHitscanVisualInfo : compact %lld bits, without seed"), VisualWriter.GetNumBits()));
+    TestTrue(TEXT("Unseeded visual info skips seed"), VisualWriter.GetNumBits() < 32 + 2 * 3 * 32);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOpenTournamentFireSchedulerSameFrameTest, "OpenTournament.Feature.Weapons.FireSchedulerSameFrame", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+* A delayed shot and the end of the previous cooldown, due in the same frame.
+* The shot starts a new cooldown, which the older cooldown event must not end.
+*/
+bool FOpenTournamentFireSchedulerSameFrameTest::RunTest(const FString& Parameters)
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+    UUR_FireSchedulerSubsystem* Scheduler = World ? World->GetSubsystem<UUR_FireSchedulerSubsystem>() : nullptr;
+    AActor* Owner = World ? World->SpawnActor<AActor>() : nullptr;
+    if (!TestNotNull(TEXT("Scheduler"), Scheduler) || !TestNotNull(TEXT("Owner"), Owner))
+    {
+        if (World)
+        {
+            World->DestroyWorld(false);
+        }
+        return false;
+    }
+
+    World->TimeSeconds = 10.f;
+
+    // No callback interface, shots only go through the fire mode timings
+    UUR_FireModeBasic* FireMode = NewObject<UUR_FireModeBasic>(Owner);
+    FireMode->RegisterComponent();
+    UUR_FireModeBasicData* FireModeData = NewObject<UUR_FireModeBasicData>(FireMode);
+    FireModeData->FireInterval = 1.f;
+    FireMode->FireModeData = FireModeData;
+    FireMode->bIsBusy = true;
+    FireMode->bRequestedFire = false;
+
+    // Shot received slightly early, waiting for the cooldown that ends right after it
+    FireMode->SetCooldownEndTime(9.99f);
+    Scheduler->Schedule(FireMode, EUR_FireScheduleEvent::DelayedFire, 9.98f);
+
+    Scheduler->DispatchDueEvents();
+
+    TestEqual(TEXT("Cooldown restarted by the delayed shot"), FireMode->CooldownEndTime, 11.f);
+    TestTrue(TEXT("Still busy until the new cooldown ends"), FireMode->bIsBusy);
+
+    // New cooldown still ends on time
+    World->TimeSeconds = 11.f;
+    Scheduler->DispatchDueEvents();
+
+    TestFalse(TEXT("Idle after the new cooldown"), FireMode->bIsBusy);
+    TestFalse(TEXT("No cooldown left"), FireMode->IsCooldownActive());
+
+    World->DestroyWorld(false);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -4,11 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "UR_FireModeBase.h"
+#include "UR_FireSchedulerSubsystem.h"
 #include "UR_FunctionLibrary.h"
 #include "UR_FireModeBasic.generated.h"
 
 class AUR_Projectile;
 class IUR_FireModeBasicInterface;
+class UMaterialInterface;
+class UStaticMesh;
 
 /**
 * Stores information about a simulated shot,
@@ -19,6 +22,8 @@ class IUR_FireModeBasicInterface;
 *
 * It is intentionally very generic to support many sorts of hitscan implementations.
 * eg. piercing rail, bouncing beam, seeded shotgun
+*
+* Replication uses a compact layout for the standard case, see NetSerialize.
 */
 USTRUCT(BlueprintType)
 struct FSimulatedShotInfo
@@ -33,6 +38,44 @@ struct FSimulatedShotInfo
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     int32 Seed;
+
+    /**
+    * Server world time the client was seeing when firing.
+    * Used by authority to rewind hitboxes (lag compensation).
+    */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float ClientTime;
+
+    /**
+    * Identifies a client-predicted projectile shot, so the server projectile can be matched with the fake one.
+    * Zero when the shot is not predicted.
+    */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    uint8 ShotId;
+
+    FSimulatedShotInfo()
+        : Seed(0)
+        , ClientTime(0.f)
+        , ShotId(0)
+    {
+    }
+
+    /**
+    * Standard layout (fire location + direction, no actors) is sent as
+    * a location quantized to 0.1 (like FVector_NetQuantize10) and a direction packed as a normal.
+    * Anything else falls back to full precision arrays.
+    * Seed and ShotId are only sent when non-zero.
+    */
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FSimulatedShotInfo> : public TStructOpsTypeTraitsBase2<FSimulatedShotInfo>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
 };
 
 /**
@@ -41,6 +84,8 @@ struct FSimulatedShotInfo
 *
 * Intentionally also generic to support many sorts of hitscan implementations.
 * eg. bouncing beam, seeded shotgun
+*
+* Replication uses a compact layout for the standard case, see NetSerialize.
 */
 USTRUCT(BlueprintType)
 struct FHitscanVisualInfo
@@ -52,6 +97,28 @@ struct FHitscanVisualInfo
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     int32 Seed;
+
+    FHitscanVisualInfo()
+        : Seed(0)
+    {
+    }
+
+    /**
+    * Standard layout (location + normal) is sent as
+    * a location quantized to 0.1 (like FVector_NetQuantize10) and a packed normal.
+    * Anything else falls back to a full precision array.
+    * Seed is only sent when non-zero.
+    */
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FHitscanVisualInfo> : public TStructOpsTypeTraitsBase2<FHitscanVisualInfo>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
 };
 
 
@@ -63,17 +130,36 @@ class OPENTOURNAMENT_API UUR_FireModeBasic : public UUR_FireModeBase
 {
 	GENERATED_BODY()
 
+#if WITH_DEV_AUTOMATION_TESTS
+    friend class FOpenTournamentFireSchedulerSameFrameTest;
+#endif
+
 public:
     UUR_FireModeBasic()
     {
-        FireInterval = 1.0f;
-        HitscanTraceDistance = 10000;
-        BeamVectorParamName = FName(TEXT("BeamVector"));
+        CooldownStartTime = 0.f;
+        CooldownEndTime = 0.f;
+        ChainedFireTime = 0.f;
+        LastShotId = 0;
+#if WITH_EDITORONLY_DATA
+        FireInterval_DEPRECATED = 1.0f;
+        FireSound_DEPRECATED = nullptr;
+        bPredictProjectile_DEPRECATED = false;
+        HitscanTraceDistance_DEPRECATED = 10000;
+        HitscanDamage_DEPRECATED = 0.f;
+        BeamTemplate_DEPRECATED = nullptr;
+        BeamVectorParamName_DEPRECATED = FName(TEXT("BeamVector"));
+        bUseTracerRenderer_DEPRECATED = false;
+        TracerMesh_DEPRECATED = nullptr;
+        TracerMaterial_DEPRECATED = nullptr;
+        TracerColor_DEPRECATED = FLinearColor(1.f, 0.8f, 0.4f);
+        TracerWidth_DEPRECATED = 2.f;
+        TracerLifeTime_DEPRECATED = 0.1f;
+        BeamImpactTemplate_DEPRECATED = nullptr;
+        BeamImpactSound_DEPRECATED = nullptr;
+#endif
     }
 
-    UPROPERTY(EditAnywhere, Category = "FireMode")
-    float FireInterval;
-
     /**
     * Dictates whether to trigger the Hitscan callbacks or the regular ones.
     * See delegates definitions.
@@ -83,32 +169,96 @@ public:
 
 public:
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    USoundBase* FireSound;
+#if WITH_EDITORONLY_DATA
+    /**
+    * Former inline FireMode and Content properties, only loaded to be migrated into FireModeData. See PostLoad.
+    */
+    UPROPERTY()
+    float FireInterval_DEPRECATED;
+
+    UPROPERTY()
+    USoundBase* FireSound_DEPRECATED;
+
+    UPROPERTY()
+    TSubclassOf<AUR_Projectile> ProjectileClass_DEPRECATED;
+
+    UPROPERTY()
+    bool bPredictProjectile_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Projectile")
-    TSubclassOf<AUR_Projectile> ProjectileClass;
+    UPROPERTY()
+    float HitscanTraceDistance_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    float HitscanTraceDistance;
+    UPROPERTY()
+    float HitscanDamage_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    float HitscanDamage;
+    UPROPERTY()
+    TSubclassOf<UDamageType> HitscanDamageType_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    TSubclassOf<UDamageType> HitscanDamageType;
+    UPROPERTY()
+    UFXSystemAsset* BeamTemplate_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    UFXSystemAsset* BeamTemplate;
+    UPROPERTY()
+    FName BeamVectorParamName_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    FName BeamVectorParamName;
+    UPROPERTY()
+    bool bUseTracerRenderer_DEPRECATED;
+
+    UPROPERTY()
+    UStaticMesh* TracerMesh_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    UParticleSystem* BeamImpactTemplate;
+    UPROPERTY()
+    UMaterialInterface* TracerMaterial_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    USoundBase* BeamImpactSound;
+    UPROPERTY()
+    FLinearColor TracerColor_DEPRECATED;
+
+    UPROPERTY()
+    float TracerWidth_DEPRECATED;
+
+    UPROPERTY()
+    float TracerLifeTime_DEPRECATED;
+
+    UPROPERTY()
+    UParticleSystem* BeamImpactTemplate_DEPRECATED;
+
+    UPROPERTY()
+    USoundBase* BeamImpactSound_DEPRECATED;
+#endif
+
+    FORCEINLINE const UUR_FireModeBasicData* GetBasicData() const
+    {
+        const UUR_FireModeBasicData* Data = Cast<UUR_FireModeBasicData>(FireModeData);
+        return Data ? Data : GetDefault<UUR_FireModeBasicData>();
+    }
+
+    FORCEINLINE float GetFireInterval() const { return GetBasicData()->FireInterval; }
+    FORCEINLINE USoundBase* GetFireSound() const { return GetBasicData()->FireSound; }
+    FORCEINLINE TSubclassOf<AUR_Projectile> GetProjectileClass() const { return GetBasicData()->ProjectileClass; }
+    FORCEINLINE bool ShouldPredictProjectile() const { return GetBasicData()->bPredictProjectile; }
+    FORCEINLINE float GetHitscanTraceDistance() const { return GetBasicData()->HitscanTraceDistance; }
+    FORCEINLINE TSubclassOf<UDamageType> GetHitscanDamageType() const { return GetBasicData()->HitscanDamageType; }
+    FORCEINLINE UFXSystemAsset* GetBeamTemplate() const { return GetBasicData()->BeamTemplate; }
+    FORCEINLINE FName GetBeamVectorParamName() const { return GetBasicData()->BeamVectorParamName; }
+    FORCEINLINE bool ShouldUseTracerRenderer() const { return GetBasicData()->bUseTracerRenderer; }
+    FORCEINLINE UStaticMesh* GetTracerMesh() const { return GetBasicData()->TracerMesh; }
+    FORCEINLINE UMaterialInterface* GetTracerMaterial() const { return GetBasicData()->TracerMaterial; }
+    FORCEINLINE FLinearColor GetTracerColor() const { return GetBasicData()->TracerColor; }
+    FORCEINLINE float GetTracerWidth() const { return GetBasicData()->TracerWidth; }
+    FORCEINLINE float GetTracerLifeTime() const { return GetBasicData()->TracerLifeTime; }
+    FORCEINLINE UParticleSystem* GetBeamImpactTemplate() const { return GetBasicData()->BeamImpactTemplate; }
+    FORCEINLINE USoundBase* GetBeamImpactSound() const { return GetBasicData()->BeamImpactSound; }
+
+    /**
+    * Damage of a hitscan shot. Charged fire mode scales it with the charge.
+    */
+    virtual float GetHitscanDamage() const { return GetBasicData()->HitscanDamage; }
+
+protected:
+
+#if WITH_EDITORONLY_DATA
+    virtual TSubclassOf<UUR_FireModeData> GetFireModeDataClass() const override { return UUR_FireModeBasicData::StaticClass(); }
+    virtual void CopyDeprecatedContent(UUR_FireModeData* Data) const override;
+#endif
 
 public:
 
@@ -125,6 +275,19 @@ public:
     virtual float GetTimeUntilIdle_Implementation() override;
     virtual float GetCooldownStartTime_Implementation() override;
 
+    /**
+    * Multicast visuals of a hitscan shot whose resolution was deferred.
+    * If AuthorityHitscanShot returns an empty HitscanInfo, the implementer is responsible for calling this later.
+    */
+    UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
+    void AuthorityHitscanShotResolved(const FHitscanVisualInfo& HitscanInfo);
+
+    /**
+    * Called by UUR_FireSchedulerSubsystem when a scheduled event is due.
+    * DueTime is the exact time the event was scheduled for, which may be earlier than current time.
+    */
+    virtual void OnScheduledEvent(EUR_FireScheduleEvent Event, float DueTime);
+
 protected:
 
     /**
@@ -137,7 +300,48 @@ protected:
     UFUNCTION()
     virtual void CooldownTimer();
 
-    FTimerHandle CooldownTimerHandle;
+    /**
+    * Cooldown timings, driven by UUR_FireSchedulerSubsystem.
+    * CooldownEndTime is zero when there is no pending cooldown.
+    */
+    float CooldownStartTime;
+    float CooldownEndTime;
+
+    /**
+    * Due time of the cooldown being processed.
+    * When refiring from the fire loop, next cooldown starts from there instead of current time,
+    * carrying over the sub-frame remainder.
+    */
+    float ChainedFireTime;
+
+    /**
+    * Start a cooldown of given duration, chained to the previous one when refiring from the fire loop.
+    */
+    void SetCooldown(float Duration);
+
+    /**
+    * Move the end of the current cooldown.
+    */
+    void SetCooldownEndTime(float EndTime);
+
+    float GetCooldownRemaining() const;
+
+    FORCEINLINE bool IsCooldownActive() const { return CooldownEndTime > 0.f; }
+
+    /**
+    * Fire DelayedShotInfo (or equivalent) after given delay.
+    */
+    void ScheduleDelayedFire(float Delay);
+
+    virtual void DelayedFireCallback();
+
+    UUR_FireSchedulerSubsystem* GetFireScheduler() const;
+
+public:
+
+    virtual void ResetFireMode() override;
+
+protected:
 
     UFUNCTION(Server, Reliable)
     void ServerFire(const FSimulatedShotInfo& SimulatedInfo);
@@ -145,7 +349,19 @@ protected:
     UFUNCTION(BlueprintAuthorityOnly)
     virtual void AuthorityShot(const FSimulatedShotInfo& SimulatedInfo);
 
-    FTimerHandle DelayedFireTimerHandle;
+    /** Shot received slightly early by server, waiting for cooldown */
+    FSimulatedShotInfo DelayedShotInfo;
+
+    /**
+    * Last ShotId given to a predicted shot. Owner client only.
+    */
+    uint8 LastShotId;
+
+    /**
+    * Server discarded a predicted shot, kill the fake projectile.
+    */
+    UFUNCTION(Client, Reliable)
+    void ClientRejectShot(uint8 ShotId);
 
     UFUNCTION(NetMulticast, Reliable)
     void MulticastFired();
@@ -197,6 +413,7 @@ public:
     /**
     * Perform hitscan shot on authority side, using simulated info passed from client.
     * Return visual info in the HitscanVisualInfo struct, to replicate visuals on other clients.
+    * Leave it empty to defer resolution, and call FireMode->AuthorityHitscanShotResolved once done.
     */
     UFUNCTION(BlueprintNativeEvent, BlueprintAuthorityOnly, BlueprintCallable)
     void AuthorityHitscanShot(UUR_FireModeBasic* FireMode, const FSimulatedShotInfo& SimulatedInfo, FHitscanVisualInfo& OutHitscanInfo);
@@ -14,6 +14,22 @@ void UUR_FireModeCharged::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
     DOREPLIFETIME_CONDITION(UUR_FireModeCharged, ChargePausedAt, COND_None);
 }
 
+#if WITH_EDITORONLY_DATA
+void UUR_FireModeCharged::CopyDeprecatedContent(UUR_FireModeData* Data) const
+{
+    Super::CopyDeprecatedContent(Data);
+
+    if (UUR_FireModeChargedData* ChargedData = Cast<UUR_FireModeChargedData>(Data))
+    {
+        ChargedData->MaxChargeLevel = MaxChargeLevel_DEPRECATED;
+        ChargedData->ChargeInterval = ChargeInterval_DEPRECATED;
+        ChargedData->MaxChargeHoldTime = MaxChargeHoldTime_DEPRECATED;
+        ChargedData->HitscanDamageMin = HitscanDamageMin_DEPRECATED;
+        ChargedData->HitscanDamageMax = HitscanDamageMax_DEPRECATED;
+    }
+}
+#endif
+
 
 //============================================================
 // Core
@@ -72,9 +88,9 @@ void UUR_FireModeCharged::NextChargeLevel()
     }
 
     // Prep next charge
-    if (ChargeLevel < MaxChargeLevel)
+    if (ChargeLevel < GetMaxChargeLevel())
     {
-        float Delay = FMath::Max(ChargeInterval, 0.001f);
+        float Delay = FMath::Max(GetChargeInterval(), 0.001f);
         GetWorld()->GetTimerManager().SetTimer(ChargeTimerHandle, this, &UUR_FireModeCharged::NextChargeLevel, Delay, false);
     }
 
@@ -85,9 +101,9 @@ void UUR_FireModeCharged::NextChargeLevel()
     }
 
     // If max charge, and if callback did not set hold timeout, do it
-    if (ChargeLevel == MaxChargeLevel && ChargePausedAt == 0)
+    if (ChargeLevel == GetMaxChargeLevel() && ChargePausedAt == 0)
     {
-        SetHoldTimeout(MaxChargeHoldTime);
+        SetHoldTimeout(GetMaxChargeHoldTime());
     }
 }
 
@@ -129,6 +145,16 @@ void UUR_FireModeCharged::HoldTimeout()
     ReleaseCharge(true);
 }
 
+void UUR_FireModeCharged::ResetFireMode()
+{
+    Super::ResetFireMode();
+
+    GetWorld()->GetTimerManager().ClearTimer(ChargeTimerHandle);
+    ChargeLevel = 0;
+    ChargePausedAt = 0;
+    ChargedHitscanDamage = 0.f;
+}
+
 void UUR_FireModeCharged::StopFire_Implementation()
 {
     ReleaseCharge();
@@ -177,16 +203,24 @@ void UUR_FireModeCharged::ServerStartCharge_Implementation()
             UE_LOG(LogWeapon, Log, TEXT("ServerStartCharge Delay = %f"), Delay);
             if (Delay < TIMEUNTILFIRE_NEVER)
             {
-                GetWorld()->GetTimerManager().SetTimer(DelayedFireTimerHandle, this, &UUR_FireModeCharged::ServerStartCharge_Implementation, Delay, false);
+                ScheduleDelayedFire(Delay);
             }
             return;
         }
     }
-    GetWorld()->GetTimerManager().ClearTimer(DelayedFireTimerHandle);
+    if (UUR_FireSchedulerSubsystem* Scheduler = GetFireScheduler())
+    {
+        Scheduler->Cancel(this, EUR_FireScheduleEvent::DelayedFire);
+    }
 
     StartCharge();
 }
 
+void UUR_FireModeCharged::DelayedFireCallback()
+{
+    ServerStartCharge_Implementation();
+}
+
 void UUR_FireModeCharged::MulticastStartCharge_Implementation()
 {
     if (GetNetMode() == NM_Client)
@@ -258,13 +292,13 @@ float UUR_FireModeCharged::GetTimeUntilIdle_Implementation()
 {
     if (bIsBusy)
     {
-        if (GetWorld()->GetTimerManager().TimerExists(CooldownTimerHandle))
+        if (IsCooldownActive())
         {
-            return GetWorld()->GetTimerManager().GetTimerRemaining(CooldownTimerHandle);
+            return GetCooldownRemaining();
         }
         else
         {
-            return FireInterval;
+            return GetFireInterval();
         }
     }
     return 0.f;
@@ -274,9 +308,9 @@ float UUR_FireModeCharged::GetCooldownStartTime_Implementation()
 {
     if (bIsBusy)
     {
-        if (GetWorld()->GetTimerManager().TimerExists(CooldownTimerHandle))
+        if (IsCooldownActive())
         {
-            return GetWorld()->GetTimeSeconds() - GetWorld()->GetTimerManager().GetTimerElapsed(CooldownTimerHandle);
+            return CooldownStartTime;
         }
         else
         {
@@ -289,13 +323,13 @@ float UUR_FireModeCharged::GetCooldownStartTime_Implementation()
 
 float UUR_FireModeCharged::GetTotalChargePercent(bool bIncludePartial)
 {
-    if (ChargeLevel >= MaxChargeLevel)
+    if (ChargeLevel >= GetMaxChargeLevel())
     {
         return 1.f;
     }
     if (ChargeLevel > 0)
     {
-        float OneCharge = 1.f / (float)(MaxChargeLevel - 1);
+        float OneCharge = 1.f / (float)(GetMaxChargeLevel() - 1);
 
         float Integral = (float)(ChargeLevel - 1) * OneCharge;
 
@@ -304,7 +338,7 @@ float UUR_FireModeCharged::GetTotalChargePercent(bool bIncludePartial)
             return Integral;
         }
 
-        float PartialPct = 1.f - GetWorld()->GetTimerManager().GetTimerRemaining(ChargeTimerHandle) / ChargeInterval;
+        float PartialPct = 1.f - GetWorld()->GetTimerManager().GetTimerRemaining(ChargeTimerHandle) / GetChargeInterval();
 
         return Integral + PartialPct * OneCharge;
     }
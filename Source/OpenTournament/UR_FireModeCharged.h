@@ -19,44 +19,65 @@ class OPENTOURNAMENT_API UUR_FireModeCharged : public UUR_FireModeBasic
 public:
     UUR_FireModeCharged()
     {
-        MaxChargeLevel = 5;
-        ChargeInterval = 0.25f;
-        MaxChargeHoldTime = -1;
+        ChargedHitscanDamage = 0.f;
+#if WITH_EDITORONLY_DATA
+        MaxChargeLevel_DEPRECATED = 5;
+        ChargeInterval_DEPRECATED = 0.25f;
+        MaxChargeHoldTime_DEPRECATED = -1;
+        HitscanDamageMin_DEPRECATED = 0.f;
+        HitscanDamageMax_DEPRECATED = 0.f;
+#endif
     }
 
-    /**
-    * Maximum charge level. Charging starts at 1.
-    */
-    UPROPERTY(EditAnywhere, Category = "FireMode")
-    int32 MaxChargeLevel;
+public:
 
+#if WITH_EDITORONLY_DATA
     /**
-    * Interval between each ChargeLevel increment.
-    * First charge (1) is immediate.
+    * Former inline FireMode and Content properties, only loaded to be migrated into FireModeData. See PostLoad.
     */
-    UPROPERTY(EditAnywhere, Category = "FireMode")
-    float ChargeInterval;
+    UPROPERTY()
+    int32 MaxChargeLevel_DEPRECATED;
 
-    /**
-    * Maximum hold time AFTER reaching full charge.
-    * Use -1 for infinite.
-    */
-    UPROPERTY(EditAnywhere, Category = "FireMode")
-    float MaxChargeHoldTime;
+    UPROPERTY()
+    float ChargeInterval_DEPRECATED;
 
-public:
+    UPROPERTY()
+    float MaxChargeHoldTime_DEPRECATED;
 
-    /**
-    * Hitscan damage of an uncharged shot.
-    */
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    float HitscanDamageMin;
+    UPROPERTY()
+    float HitscanDamageMin_DEPRECATED;
+
+    UPROPERTY()
+    float HitscanDamageMax_DEPRECATED;
+#endif
+
+    FORCEINLINE const UUR_FireModeChargedData* GetChargedData() const
+    {
+        const UUR_FireModeChargedData* Data = Cast<UUR_FireModeChargedData>(FireModeData);
+        return Data ? Data : GetDefault<UUR_FireModeChargedData>();
+    }
+
+    FORCEINLINE int32 GetMaxChargeLevel() const { return GetChargedData()->MaxChargeLevel; }
+    FORCEINLINE float GetChargeInterval() const { return GetChargedData()->ChargeInterval; }
+    FORCEINLINE float GetMaxChargeHoldTime() const { return GetChargedData()->MaxChargeHoldTime; }
+    FORCEINLINE float GetHitscanDamageMin() const { return GetChargedData()->HitscanDamageMin; }
+    FORCEINLINE float GetHitscanDamageMax() const { return GetChargedData()->HitscanDamageMax; }
 
     /**
-    * Hitscan damage of a fully charged shot.
+    * Hitscan damage of the shot being charged, updated at each charge level.
+    * Runtime state, the shared content only holds the min/max range.
     */
-    UPROPERTY(EditAnywhere, Category = "Content|Hitscan")
-    float HitscanDamageMax;
+    UPROPERTY(BlueprintReadWrite, Category = "Content|Runtime")
+    float ChargedHitscanDamage;
+
+    virtual float GetHitscanDamage() const override { return ChargedHitscanDamage; }
+
+protected:
+
+#if WITH_EDITORONLY_DATA
+    virtual TSubclassOf<UUR_FireModeData> GetFireModeDataClass() const override { return UUR_FireModeChargedData::StaticClass(); }
+    virtual void CopyDeprecatedContent(UUR_FireModeData* Data) const override;
+#endif
 
 public:
 
@@ -103,6 +124,8 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual void BlockNextCharge(float MaxHoldTime);
 
+    virtual void ResetFireMode() override;
+
     // Override to avoid calling StopFire() which would release the charge.
     virtual void SetRequestIdle_Implementation(bool bNewRequestIdle)
     {
@@ -141,6 +164,8 @@ protected:
 
     virtual void CooldownTimer() override;
 
+    virtual void DelayedFireCallback() override;
+
     // Replication
 
     UFUNCTION(Server, Reliable)
@@ -3,10 +3,15 @@
 #include "UR_FireModeContinuous.h"
 
 #include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
 #include "TimerManager.h"
 
+#include "OpenTournament.h"
 #include "UR_FunctionLibrary.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Beam Trace Cache Hits"), STAT_OT_BeamTraceCacheHits, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Beam Trace Cache Misses"), STAT_OT_BeamTraceCacheMisses, STATGROUP_OpenTournament);
+
 /**
 * NOTE:
 * The spinup routine already has replication mechanisms which are exactly what we want.
@@ -16,6 +21,34 @@
 * The only downside is that interface's SpinUp callbacks are going to be called even if there is no spinup.
 */
 
+void UUR_FireModeContinuous::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME_CONDITION(UUR_FireModeContinuous, ServerReceivedHitCount, COND_OwnerOnly);
+}
+
+#if WITH_EDITORONLY_DATA
+void UUR_FireModeContinuous::CopyDeprecatedContent(UUR_FireModeData* Data) const
+{
+    Super::CopyDeprecatedContent(Data);
+
+    if (UUR_FireModeContinuousData* ContinuousData = Cast<UUR_FireModeContinuousData>(Data))
+    {
+        ContinuousData->TraceDistance = TraceDistance_DEPRECATED;
+        ContinuousData->Damage = Damage_DEPRECATED;
+        ContinuousData->AmmoCostPerSecond = AmmoCostPerSecond_DEPRECATED;
+        ContinuousData->DamageType = DamageType_DEPRECATED;
+        ContinuousData->BeamTemplate = BeamTemplate_DEPRECATED;
+        ContinuousData->BeamVectorParamName = BeamVectorParamName_DEPRECATED;
+        ContinuousData->BeamImpactNormalParamName = BeamImpactNormalParamName_DEPRECATED;
+        ContinuousData->FireLoopSound = FireLoopSound_DEPRECATED;
+        ContinuousData->FireEndSound = FireEndSound_DEPRECATED;
+        ContinuousData->BeamImpactSound = BeamImpactSound_DEPRECATED;
+    }
+}
+#endif
+
 void UUR_FireModeContinuous::RequestStartFire_Implementation()
 {
     bRequestedFire = true;
@@ -26,6 +59,7 @@ void UUR_FireModeContinuous::RequestStartFire_Implementation()
 void UUR_FireModeContinuous::StartFire_Implementation()
 {
     DeltaTimeAccumulator = 0.f;
+    CachedTraceTime = -1.f;
     SetComponentTickEnabled(true);
 
     if (ContinuousInterface)
@@ -39,6 +73,22 @@ void UUR_FireModeContinuous::StartFire_Implementation()
             IUR_FireModeContinuousInterface::Execute_AuthorityStartContinuousFire(ContinuousInterface.GetObject(), this);
         }
     }
+
+    // Forget about targets that are gone
+    for (auto It = ServerHitCredit.CreateIterator(); It; ++It)
+    {
+        if (!It.Key().IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+    for (auto It = ServerLastObservedHits.CreateIterator(); It; ++It)
+    {
+        if (!It.Key().IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
 }
 
 void UUR_FireModeContinuous::StopFire_Implementation()
@@ -47,6 +97,20 @@ void UUR_FireModeContinuous::StopFire_Implementation()
     SpinDown();
 }
 
+void UUR_FireModeContinuous::ResetFireMode()
+{
+    Super::ResetFireMode();
+
+    GetWorld()->GetTimerManager().ClearTimer(HitReportTimerHandle);
+    AmmoCostAccumulator = 0.f;
+    CachedTraceTime = -1.f;
+    ClientHitHistory.Empty();
+    ClientHistoryBaseCount = 0;
+    ServerReceivedHitCount = 0;
+    ServerHitCredit.Empty();
+    ServerLastObservedHits.Empty();
+}
+
 void UUR_FireModeContinuous::SpinDown()
 {
     SetComponentTickEnabled(false);
@@ -120,3 +184,184 @@ void UUR_FireModeContinuous::TickComponent(float DeltaTime, enum ELevelTick Tick
     // BP Tick
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 }
+
+
+//============================================================
+// Client side hit registration
+//============================================================
+
+bool UUR_FireModeContinuous::IsClientSideHitReg() const
+{
+    if (!bClientSideHitReg || GetSpread() > 0.f)
+    {
+        return false;
+    }
+    // Locally controlled on authority = bot, listen server host or standalone
+    return !(GetOwnerRole() == ROLE_Authority && UUR_FunctionLibrary::IsComponentLocallyControlled(this));
+}
+
+bool UUR_FireModeContinuous::ShouldReportHit(AActor* Target) const
+{
+    // Client can only report actors which server knows about
+    return IsValid(Target) && Target->GetIsReplicated() && Target->CanBeDamaged();
+}
+
+void UUR_FireModeContinuous::ClientRegisterHit(AActor* Target)
+{
+    if (ClientHitHistory.Num() > 0 && ClientHitHistory.Last().Target == Target && ClientHitHistory.Last().HitCount < MAX_uint8)
+    {
+        ClientHitHistory.Last().HitCount++;
+    }
+    else
+    {
+        ClientHitHistory.Add({ Target, 1 });
+    }
+
+    if (!GetWorld()->GetTimerManager().IsTimerActive(HitReportTimerHandle))
+    {
+        SendHitReport();
+        GetWorld()->GetTimerManager().SetTimer(HitReportTimerHandle, this, &UUR_FireModeContinuous::SendHitReport, HitReportInterval, true);
+    }
+}
+
+void UUR_FireModeContinuous::SendHitReport()
+{
+    if (ClientHitHistory.Num() == 0)
+    {
+        GetWorld()->GetTimerManager().ClearTimer(HitReportTimerHandle);
+        return;
+    }
+
+    ServerReportHitCounts(ClientHistoryBaseCount, ClientHitHistory);
+}
+
+void UUR_FireModeContinuous::OnRep_ServerReceivedHitCount()
+{
+    // Drop everything server already received
+    int32 ToRemove = ServerReceivedHitCount - ClientHistoryBaseCount;
+    int32 NumEntries = 0;
+    while (ToRemove > 0 && NumEntries < ClientHitHistory.Num())
+    {
+        FStoredTargetHitCount& Entry = ClientHitHistory[NumEntries];
+        const int32 Removed = FMath::Min<int32>(ToRemove, Entry.HitCount);
+        Entry.HitCount -= Removed;
+        ToRemove -= Removed;
+        ClientHistoryBaseCount += Removed;
+        if (Entry.HitCount == 0)
+        {
+            NumEntries++;
+        }
+    }
+    ClientHitHistory.RemoveAt(0, NumEntries, false);
+
+    if (ClientHitHistory.Num() == 0)
+    {
+        GetWorld()->GetTimerManager().ClearTimer(HitReportTimerHandle);
+    }
+}
+
+void UUR_FireModeContinuous::ServerReportHitCounts_Implementation(int32 BaseCount, const TArray<FStoredTargetHitCount>& History)
+{
+    // Client always sends everything since our last ack, so a gap only means an outdated ack. Wait for next report.
+    if (BaseCount > ServerReceivedHitCount || History.Num() > 64 || !IsClientSideHitReg())
+    {
+        return;
+    }
+
+    int32 ToSkip = ServerReceivedHitCount - BaseCount;
+    for (const FStoredTargetHitCount& Entry : History)
+    {
+        const int32 Skipped = FMath::Min<int32>(ToSkip, Entry.HitCount);
+        ToSkip -= Skipped;
+        const int32 NewHits = Entry.HitCount - Skipped;
+        if (NewHits <= 0)
+        {
+            continue;
+        }
+
+        // Acknowledge, whether we accept them or not
+        ServerReceivedHitCount += NewHits;
+
+        if (!ShouldReportHit(Entry.Target))
+        {
+            continue;
+        }
+
+        int32& Credit = ServerHitCredit.FindOrAdd(Entry.Target);
+        const int32 Accepted = FMath::Clamp(Credit + HitCountTolerance, 0, NewHits);
+        Credit -= Accepted;
+
+        if (Accepted > 0 && ContinuousInterface)
+        {
+            IUR_FireModeContinuousInterface::Execute_AuthorityContinuousHitsConfirmed(ContinuousInterface.GetObject(), this, Entry.Target, Accepted);
+        }
+    }
+}
+
+void UUR_FireModeContinuous::AuthorityObservedHit(const FHitResult& Hit)
+{
+    AActor* Target = Hit.GetActor();
+    if (!Target)
+    {
+        return;
+    }
+
+    // Don't let credit pile up beyond about one second of hits
+    const int32 MaxCredit = FMath::CeilToInt(1.f / FMath::Max(HitCheckInterval, 0.01f));
+
+    int32& Credit = ServerHitCredit.FindOrAdd(Target);
+    Credit = FMath::Min(Credit + 1, MaxCredit);
+
+    ServerLastObservedHits.Add(Target, Hit);
+}
+
+bool UUR_FireModeContinuous::GetLastObservedHit(AActor* Target, FHitResult& OutHit) const
+{
+    if (const FHitResult* Hit = ServerLastObservedHits.Find(Target))
+    {
+        OutHit = *Hit;
+        return true;
+    }
+    return false;
+}
+
+
+//============================================================
+// Beam trace cache
+//============================================================
+
+void UUR_FireModeContinuous::StoreBeamTrace(const FVector& TraceStart, const FVector& AimDir, const FHitResult& Hit)
+{
+    CachedTraceTime = GetWorld()->GetTimeSeconds();
+    CachedTraceStart = TraceStart;
+    CachedAimDir = AimDir.GetSafeNormal();
+    CachedTraceDir = (Hit.TraceEnd - Hit.TraceStart).GetSafeNormal();
+    CachedHitDistance = (Hit.Location - Hit.TraceStart).Size();
+    CachedImpactNormal = Hit.ImpactNormal;
+    bCachedBlockingHit = Hit.bBlockingHit;
+}
+
+bool UUR_FireModeContinuous::GetCachedBeamTrace(const FVector& TraceStart, const FVector& AimDir, FHitResult& OutHit) const
+{
+    if (CachedTraceTime < 0.f
+        || GetWorld()->GetTimeSeconds() - CachedTraceTime >= VisualTraceInterval
+        || FVector::DistSquared(TraceStart, CachedTraceStart) > FMath::Square(VisualRetraceDistance)
+        || (AimDir | CachedAimDir) < FMath::Cos(FMath::DegreesToRadians(VisualRetraceAngle)))
+    {
+        INC_DWORD_STAT(STAT_OT_BeamTraceCacheMisses);
+        return false;
+    }
+
+    INC_DWORD_STAT(STAT_OT_BeamTraceCacheHits);
+
+    // Keep the same spread offset, follow the current aim
+    const FVector Dir = (AimDir + CachedTraceDir - CachedAimDir).GetSafeNormal();
+
+    OutHit.TraceStart = TraceStart;
+    OutHit.TraceEnd = TraceStart + GetTraceDistance() * Dir;
+    OutHit.Location = TraceStart + CachedHitDistance * Dir;
+    OutHit.ImpactPoint = OutHit.Location;
+    OutHit.ImpactNormal = CachedImpactNormal;
+    OutHit.bBlockingHit = bCachedBlockingHit;
+    return true;
+}
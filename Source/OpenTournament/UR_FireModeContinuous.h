@@ -48,6 +48,20 @@ class IUR_FireModeContinuousInterface;
 * Investigate.
 */
 
+/*
+* Implementation (bClientSideHitReg) :
+*
+* - Client keeps a run-length history of hits (Target, HitCount) since the last ServerReceivedHitCount.
+* - Every HitReportInterval, while history is not empty, client sends it with an unreliable RPC.
+*   Total cost is one small RPC per interval while hitting, regardless of HitCheckInterval.
+* - Server skips the hits it already received, and acknowledges new ones via ServerReceivedHitCount (owner only).
+* - Server also traces every HitCheck (lag compensated, without spread like the client), and earns one hit credit per target it sees being hit.
+*   Reported hits are accepted while they don't exceed credit + HitCountTolerance.
+* - Accepted hits go through AuthorityContinuousHitsConfirmed, which applies damage with the last hit server observed on the target.
+*
+* No timestamps, server only validates counts.
+*/
+
 USTRUCT(BlueprintType)
 struct FStoredTargetHitCount
 {
@@ -76,11 +90,27 @@ public:
         PrimaryComponentTick.bStartWithTickEnabled = false;
 
         HitCheckInterval = 0.050f;
-
-        TraceDistance = 1000;
-        AmmoCostPerSecond = 1.f;
-        BeamVectorParamName = FName(TEXT("BeamVector"));
-        BeamImpactNormalParamName = FName(TEXT("ImpactNormal"));
+        bClientSideHitReg = false;
+        HitCountTolerance = 2;
+        HitReportInterval = 0.100f;
+        VisualTraceInterval = 0.033f;
+        VisualRetraceAngle = 1.5f;
+        VisualRetraceDistance = 15.f;
+        CachedTraceTime = -1.f;
+        ClientHistoryBaseCount = 0;
+        ServerReceivedHitCount = 0;
+
+#if WITH_EDITORONLY_DATA
+        TraceDistance_DEPRECATED = 1000;
+        Damage_DEPRECATED = 0.f;
+        AmmoCostPerSecond_DEPRECATED = 1.f;
+        BeamTemplate_DEPRECATED = nullptr;
+        BeamVectorParamName_DEPRECATED = FName(TEXT("BeamVector"));
+        BeamImpactNormalParamName_DEPRECATED = FName(TEXT("ImpactNormal"));
+        FireLoopSound_DEPRECATED = nullptr;
+        FireEndSound_DEPRECATED = nullptr;
+        BeamImpactSound_DEPRECATED = nullptr;
+#endif
     }
 
     /**
@@ -93,37 +123,101 @@ public:
     UPROPERTY(EditAnywhere, Category = "FireMode")
     float HitCheckInterval;
 
+    /**
+    * Let the controlling client decide hits, server only validates reported hit counts.
+    * Only used for straight beams (Spread = 0).
+    * Bots and listen server host always use server hit detection.
+    * Disabled by default, enable it on the weapons that need it.
+    */
+    UPROPERTY(EditAnywhere, Category = "FireMode")
+    bool bClientSideHitReg;
+
+    /**
+    * Number of hits client may report on a target, on top of what server traces observed.
+    */
+    UPROPERTY(EditAnywhere, Category = "FireMode", Meta = (EditCondition = "bClientSideHitReg"))
+    int32 HitCountTolerance;
+
+    /**
+    * Interval between hit reports sent by client.
+    * Unacknowledged hits are sent again at this rate until server catches up.
+    */
+    UPROPERTY(EditAnywhere, Category = "FireMode", Meta = (EditCondition = "bClientSideHitReg"))
+    float HitReportInterval;
+
+    /**
+    * Maximum age of the cached beam trace, before visuals trace again.
+    * In between, the cached result is re-projected along the current aim.
+    * 0 = trace every frame.
+    */
+    UPROPERTY(EditAnywhere, Category = "FireMode")
+    float VisualTraceInterval;
+
+    /**
+    * Aim change (degrees) from the cached trace, which forces visuals to trace again.
+    */
+    UPROPERTY(EditAnywhere, Category = "FireMode")
+    float VisualRetraceAngle;
+
+    /**
+    * Fire location change from the cached trace, which forces visuals to trace again.
+    */
+    UPROPERTY(EditAnywhere, Category = "FireMode")
+    float VisualRetraceDistance;
+
 public:
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    float TraceDistance;
+#if WITH_EDITORONLY_DATA
+    /**
+    * Former inline Content, only loaded to be migrated into FireModeData. See PostLoad.
+    */
+    UPROPERTY()
+    float TraceDistance_DEPRECATED;
+
+    UPROPERTY()
+    float Damage_DEPRECATED;
+
+    UPROPERTY()
+    float AmmoCostPerSecond_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    float Damage;
+    UPROPERTY()
+    TSubclassOf<UDamageType> DamageType_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    float AmmoCostPerSecond;
+    UPROPERTY()
+    UFXSystemAsset* BeamTemplate_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    TSubclassOf<UDamageType> DamageType;
+    UPROPERTY()
+    FName BeamVectorParamName_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    UFXSystemAsset* BeamTemplate;
+    UPROPERTY()
+    FName BeamImpactNormalParamName_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    FName BeamVectorParamName;
+    UPROPERTY()
+    USoundBase* FireLoopSound_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    FName BeamImpactNormalParamName;
+    UPROPERTY()
+    USoundBase* FireEndSound_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    USoundBase* FireLoopSound;
+    UPROPERTY()
+    USoundBase* BeamImpactSound_DEPRECATED;
+#endif
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    USoundBase* FireEndSound;
+    FORCEINLINE const UUR_FireModeContinuousData* GetContinuousData() const
+    {
+        const UUR_FireModeContinuousData* Data = Cast<UUR_FireModeContinuousData>(FireModeData);
+        return Data ? Data : GetDefault<UUR_FireModeContinuousData>();
+    }
 
-    UPROPERTY(EditAnywhere, Category = "Content")
-    USoundBase* BeamImpactSound;
+    FORCEINLINE float GetTraceDistance() const { return GetContinuousData()->TraceDistance; }
+    FORCEINLINE float GetDamage() const { return GetContinuousData()->Damage; }
+    FORCEINLINE float GetAmmoCostPerSecond() const { return GetContinuousData()->AmmoCostPerSecond; }
+    FORCEINLINE TSubclassOf<UDamageType> GetDamageType() const { return GetContinuousData()->DamageType; }
+    FORCEINLINE UFXSystemAsset* GetBeamTemplate() const { return GetContinuousData()->BeamTemplate; }
+    FORCEINLINE FName GetBeamVectorParamName() const { return GetContinuousData()->BeamVectorParamName; }
+    FORCEINLINE FName GetBeamImpactNormalParamName() const { return GetContinuousData()->BeamImpactNormalParamName; }
+    FORCEINLINE USoundBase* GetFireLoopSound() const { return GetContinuousData()->FireLoopSound; }
+    FORCEINLINE USoundBase* GetFireEndSound() const { return GetContinuousData()->FireEndSound; }
+    FORCEINLINE USoundBase* GetBeamImpactSound() const { return GetContinuousData()->BeamImpactSound; }
 
     UPROPERTY(BlueprintReadWrite, Category = "Content|Runtime")
     UFXSystemComponent* BeamComponent;
@@ -153,9 +247,110 @@ public:
     virtual void StopFire_Implementation() override;
     virtual void SpinDown() override;
     virtual float GetTimeUntilIdle_Implementation() override;
+    virtual void ResetFireMode() override;
+
+    /**
+    * Whether hits are decided by the controlling client on this machine.
+    * True on a remote owner client, and on server for a remote owner.
+    */
+    UFUNCTION(BlueprintPure)
+    bool IsClientSideHitReg() const;
+
+    /**
+    * Whether a hit on this actor should be reported to / validated by server.
+    */
+    virtual bool ShouldReportHit(AActor* Target) const;
+
+    /**
+    * Owner client: count one hit on Target, to be reported to server.
+    */
+    UFUNCTION(BlueprintCallable)
+    void ClientRegisterHit(AActor* Target);
+
+    /**
+    * Authority: count one hit observed by server on the hit actor, allowing client to report it.
+    * The hit is kept to apply confirmed damage, see GetLastObservedHit.
+    */
+    UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
+    void AuthorityObservedHit(const FHitResult& Hit);
+
+    /**
+    * Authority: most recent hit observed by server on Target.
+    * Returns false if server never observed a hit on Target (eg. hit accepted through tolerance).
+    */
+    UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
+    bool GetLastObservedHit(AActor* Target, FHitResult& OutHit) const;
+
+    /**
+    * Store the latest beam trace, from visuals or hit checks.
+    * AimDir is the aim direction before spread.
+    */
+    UFUNCTION(BlueprintCallable)
+    void StoreBeamTrace(const FVector& TraceStart, const FVector& AimDir, const FHitResult& Hit);
+
+    /**
+    * Retrieve the cached beam trace, re-projected from given location and aim.
+    * Returns false if the cache is too old or aim moved too much, in which case caller should trace again.
+    */
+    UFUNCTION(BlueprintCallable)
+    bool GetCachedBeamTrace(const FVector& TraceStart, const FVector& AimDir, FHitResult& OutHit) const;
 
 protected:
 
+#if WITH_EDITORONLY_DATA
+    virtual TSubclassOf<UUR_FireModeData> GetFireModeDataClass() const override { return UUR_FireModeContinuousData::StaticClass(); }
+    virtual void CopyDeprecatedContent(UUR_FireModeData* Data) const override;
+#endif
+
+    //============================================================
+    // Beam trace cache
+    //============================================================
+
+    /** World time of the cached trace, negative when there is none */
+    float CachedTraceTime;
+
+    FVector CachedTraceStart;
+
+    /** Aim direction before spread */
+    FVector CachedAimDir;
+
+    /** Actual trace direction, after spread */
+    FVector CachedTraceDir;
+
+    float CachedHitDistance;
+
+    FVector CachedImpactNormal;
+
+    bool bCachedBlockingHit;
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    /** Hits not acknowledged by server yet, run-length encoded, oldest first */
+    TArray<FStoredTargetHitCount> ClientHitHistory;
+
+    /** Total hits counted by client before the first entry of ClientHitHistory */
+    int32 ClientHistoryBaseCount;
+
+    FTimerHandle HitReportTimerHandle;
+
+    void SendHitReport();
+
+    /** Total hits received and processed by server */
+    UPROPERTY(ReplicatedUsing = OnRep_ServerReceivedHitCount)
+    int32 ServerReceivedHitCount;
+
+    UFUNCTION()
+    virtual void OnRep_ServerReceivedHitCount();
+
+    UFUNCTION(Server, Unreliable)
+    void ServerReportHitCounts(int32 BaseCount, const TArray<FStoredTargetHitCount>& History);
+
+    /** Hits observed by server traces and not claimed by client yet, per target */
+    TMap<TWeakObjectPtr<AActor>, int32> ServerHitCredit;
+
+    /** Most recent hit observed by server traces, per target */
+    TMap<TWeakObjectPtr<AActor>, FHitResult> ServerLastObservedHits;
+
     /*
     virtual void BeginPlay() override
     {
@@ -208,6 +403,13 @@ public:
     UFUNCTION(BlueprintNativeEvent, BlueprintAuthorityOnly, BlueprintCallable)
     void AuthorityStopContinuousFire(UUR_FireModeContinuous* FireMode);
 
+    /**
+    * Called on authority when client side hits have been reported and validated.
+    * See bClientSideHitReg.
+    */
+    UFUNCTION(BlueprintNativeEvent, BlueprintAuthorityOnly, BlueprintCallable)
+    void AuthorityContinuousHitsConfirmed(UUR_FireModeContinuous* FireMode, AActor* Target, int32 HitCount);
+
     /**
     * Called when starting continuous firing, on all clients.
     */
@@ -0,0 +1,261 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "UR_FireModeData.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AUR_Projectile;
+class UDamageType;
+class UFXSystemAsset;
+class UMaterialInterface;
+class UParticleSystem;
+class USoundBase;
+class UStaticMesh;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Shared "Content" of a fire mode : sounds, effects, damage and tuning.
+*
+* One asset is shared by every instance of the fire mode, which only keeps a pointer to it along with its runtime state.
+* Fire modes read through the asset on each use, so balance edits apply to live weapons without respawning them.
+*
+* Fire modes without data use the defaults of the data class.
+* Their former inline Content properties are editor only, and migrated into a data object on load (see UUR_FireModeBase::PostLoad).
+*/
+UCLASS(BlueprintType)
+class OPENTOURNAMENT_API UUR_FireModeData : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    UUR_FireModeData()
+    {
+        InitialAmmoCost = 1;
+        Spread = 0.f;
+        MuzzleSocketName = FName(TEXT("Muzzle"));
+        MuzzleFlashTemplate = nullptr;
+    }
+
+    /**
+    * Minimum necessary ammo for weapon to allow firing this firemode at all.
+    * If weapon ammo is below that value, it should click as out-of-ammo.
+    */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Content")
+    int32 InitialAmmoCost;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Content")
+    float Spread;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Content")
+    FName MuzzleSocketName;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Content")
+    UFXSystemAsset* MuzzleFlashTemplate;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Content of UUR_FireModeBasic.
+*/
+UCLASS(BlueprintType)
+class OPENTOURNAMENT_API UUR_FireModeBasicData : public UUR_FireModeData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_FireModeBasicData()
+    {
+        FireInterval = 1.0f;
+        FireSound = nullptr;
+        bPredictProjectile = false;
+        HitscanTraceDistance = 10000;
+        HitscanDamage = 0.f;
+        BeamTemplate = nullptr;
+        BeamVectorParamName = FName(TEXT("BeamVector"));
+        bUseTracerRenderer = false;
+        TracerMesh = nullptr;
+        TracerMaterial = nullptr;
+        TracerColor = FLinearColor(1.f, 0.8f, 0.4f);
+        TracerWidth = 2.f;
+        TracerLifeTime = 0.1f;
+        BeamImpactTemplate = nullptr;
+        BeamImpactSound = nullptr;
+    }
+
+    UPROPERTY(EditDefaultsOnly, Category = "FireMode")
+    float FireInterval;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    USoundBase* FireSound;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Projectile")
+    TSubclassOf<AUR_Projectile> ProjectileClass;
+
+    /**
+    * Spawn a fake projectile on the shooting client right away, instead of waiting for the server one to replicate.
+    * The fake deals no damage, and is replaced by the server projectile once it arrives.
+    * Only applies to weapons using the base AUR_Weapon::SimulateShot / AuthorityShot.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Projectile")
+    bool bPredictProjectile;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    float HitscanTraceDistance;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    float HitscanDamage;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    TSubclassOf<UDamageType> HitscanDamageType;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    UFXSystemAsset* BeamTemplate;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    FName BeamVectorParamName;
+
+    /**
+    * Draw beams with the world's shared tracer renderer (see UUR_TracerSubsystem), instead of spawning BeamTemplate per shot.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    bool bUseTracerRenderer;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan", Meta = (EditCondition = "bUseTracerRenderer"))
+    UStaticMesh* TracerMesh;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan", Meta = (EditCondition = "bUseTracerRenderer"))
+    UMaterialInterface* TracerMaterial;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan", Meta = (EditCondition = "bUseTracerRenderer"))
+    FLinearColor TracerColor;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan", Meta = (EditCondition = "bUseTracerRenderer"))
+    float TracerWidth;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan", Meta = (EditCondition = "bUseTracerRenderer"))
+    float TracerLifeTime;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    UParticleSystem* BeamImpactTemplate;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    USoundBase* BeamImpactSound;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Content of UUR_FireModeCharged.
+*/
+UCLASS(BlueprintType)
+class OPENTOURNAMENT_API UUR_FireModeChargedData : public UUR_FireModeBasicData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_FireModeChargedData()
+    {
+        MaxChargeLevel = 5;
+        ChargeInterval = 0.25f;
+        MaxChargeHoldTime = -1;
+        HitscanDamageMin = 0.f;
+        HitscanDamageMax = 0.f;
+    }
+
+    /**
+    * Maximum charge level. Charging starts at 1.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "FireMode")
+    int32 MaxChargeLevel;
+
+    /**
+    * Interval between each ChargeLevel increment.
+    * First charge (1) is immediate.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "FireMode")
+    float ChargeInterval;
+
+    /**
+    * Maximum hold time AFTER reaching full charge.
+    * Use -1 for infinite.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "FireMode")
+    float MaxChargeHoldTime;
+
+    /**
+    * Hitscan damage of an uncharged shot.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    float HitscanDamageMin;
+
+    /**
+    * Hitscan damage of a fully charged shot.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Content|Hitscan")
+    float HitscanDamageMax;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Content of UUR_FireModeContinuous.
+*/
+UCLASS(BlueprintType)
+class OPENTOURNAMENT_API UUR_FireModeContinuousData : public UUR_FireModeData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_FireModeContinuousData()
+    {
+        TraceDistance = 1000;
+        Damage = 0.f;
+        AmmoCostPerSecond = 1.f;
+        BeamTemplate = nullptr;
+        BeamVectorParamName = FName(TEXT("BeamVector"));
+        BeamImpactNormalParamName = FName(TEXT("ImpactNormal"));
+        FireLoopSound = nullptr;
+        FireEndSound = nullptr;
+        BeamImpactSound = nullptr;
+    }
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    float TraceDistance;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    float Damage;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    float AmmoCostPerSecond;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    TSubclassOf<UDamageType> DamageType;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    UFXSystemAsset* BeamTemplate;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    FName BeamVectorParamName;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    FName BeamImpactNormalParamName;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    USoundBase* FireLoopSound;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    USoundBase* FireEndSound;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Content")
+    USoundBase* BeamImpactSound;
+};
@@ -24,7 +24,9 @@ public:
         PrimaryComponentTick.bStartWithTickEnabled = false;
 
         Index = 1;
-        InitialAmmoCost = 0;
+#if WITH_EDITORONLY_DATA
+        InitialAmmoCost_DEPRECATED = 0;
+#endif
 
         ZoomFOV = 50;
         ZoomInTime = 0.15f;
@@ -37,6 +39,9 @@ public:
     UPROPERTY(EditAnywhere, Category = "FireMode")
     TSubclassOf<UUserWidget> ZoomWidgetClass;
 
+    /** Zooming is free unless data says otherwise */
+    virtual int32 GetInitialAmmoCost() const override { return FireModeData ? Super::GetInitialAmmoCost() : 0; }
+
     //TODO: turn this into a client setting
     UPROPERTY(EditAnywhere, Category = "FireMode")
     float ZoomFOV;
@@ -0,0 +1,149 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_FireSchedulerSubsystem.h"
+
+#include "Engine/World.h"
+
+#include "OpenTournament.h"
+#include "UR_FireModeBasic.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fire Events Dispatched"), STAT_OT_FireEventsDispatched, STATGROUP_OpenTournament);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Events Pending"), STAT_OT_FireEventsPending, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Fire Scheduler"), STAT_OT_FireScheduler, STATGROUP_OpenTournament);
+
+/**
+* Maximum passes per frame.
+* When FireInterval is shorter than a frame, the chained next shot may already be due in the same frame.
+*/
+static const int32 MaxDispatchPasses = 4;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_FireSchedulerSubsystem::Deinitialize()
+{
+    Events.Empty();
+    DueEvents.Empty();
+
+    Super::Deinitialize();
+}
+
+int32 UUR_FireSchedulerSubsystem::FindEvent(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event) const
+{
+    for (int32 i = 0; i < Events.Num(); i++)
+    {
+        if (Events[i].Event == Event && Events[i].FireMode.Get() == FireMode)
+        {
+            return i;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void UUR_FireSchedulerSubsystem::DiscardDueEvent(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event)
+{
+    // Cleared rather than removed, DueEvents may be iterating
+    for (FUR_ScheduledFireEvent& Due : DueEvents)
+    {
+        if (Due.Event == Event && Due.FireMode.Get() == FireMode)
+        {
+            Due.FireMode.Reset();
+        }
+    }
+}
+
+void UUR_FireSchedulerSubsystem::Schedule(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event, float Time)
+{
+    // Event pulled out for dispatch but not run yet is superseded
+    DiscardDueEvent(FireMode, Event);
+
+    const int32 Index = FindEvent(FireMode, Event);
+    if (Index != INDEX_NONE)
+    {
+        Events[Index].Time = Time;
+    }
+    else
+    {
+        Events.Add({ FireMode, Time, Event });
+    }
+}
+
+void UUR_FireSchedulerSubsystem::Cancel(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event)
+{
+    DiscardDueEvent(FireMode, Event);
+
+    const int32 Index = FindEvent(FireMode, Event);
+    if (Index != INDEX_NONE)
+    {
+        Events.RemoveAtSwap(Index, 1, false);
+    }
+}
+
+void UUR_FireSchedulerSubsystem::DispatchDueEvents()
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_FireScheduler);
+
+    const float Now = GetWorld()->GetTimeSeconds();
+
+    for (int32 Pass = 0; Pass < MaxDispatchPasses; Pass++)
+    {
+        // Pull out due events (and dead fire modes) in one pass
+        for (int32 i = Events.Num() - 1; i >= 0; i--)
+        {
+            if (!Events[i].FireMode.IsValid())
+            {
+                Events.RemoveAtSwap(i, 1, false);
+            }
+            else if (Events[i].Time <= Now)
+            {
+                DueEvents.Add(Events[i]);
+                Events.RemoveAtSwap(i, 1, false);
+            }
+        }
+
+        if (DueEvents.Num() == 0)
+        {
+            break;
+        }
+
+        INC_DWORD_STAT_BY(STAT_OT_FireEventsDispatched, DueEvents.Num());
+
+        // Oldest first, so interactions between fire modes happen in the right order
+        DueEvents.Sort([](const FUR_ScheduledFireEvent& A, const FUR_ScheduledFireEvent& B)
+        {
+            return A.Time < B.Time;
+        });
+
+        for (const FUR_ScheduledFireEvent& Due : DueEvents)
+        {
+            if (UUR_FireModeBasic* FireMode = Due.FireMode.Get())
+            {
+                FireMode->OnScheduledEvent(Due.Event, Due.Time);
+            }
+        }
+
+        DueEvents.Reset();
+    }
+
+    SET_DWORD_STAT(STAT_OT_FireEventsPending, Events.Num());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_FireSchedulerSubsystem::Tick(float DeltaTime)
+{
+    DispatchDueEvents();
+}
+
+ETickableTickType UUR_FireSchedulerSubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_FireSchedulerSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_FireSchedulerSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_FireSchedulerSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class UUR_FireModeBasic;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Kinds of events a fire mode can schedule.
+*/
+enum class EUR_FireScheduleEvent : uint8
+{
+    /** End of cooldown between two shots */
+    Cooldown,
+    /** Server-side shot received slightly early, waiting for cooldown */
+    DelayedFire,
+};
+
+/**
+* A pending fire mode event.
+*/
+struct FUR_ScheduledFireEvent
+{
+    TWeakObjectPtr<UUR_FireModeBasic> FireMode;
+
+    /** World time at which the event is due */
+    float Time;
+
+    EUR_FireScheduleEvent Event;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Drives fire loops of all FireModeBasic (and Charged) in the world, replacing per-shot timers.
+*
+* Due times are stored in a flat array, scanned once per frame.
+* Events are dispatched with their exact due time, so fire modes can chain the next shot
+* from it rather than from the current frame time. Fire rate then does not depend on framerate.
+*
+* A fire mode has at most one pending event of each kind.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_FireSchedulerSubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Schedule an event at given world time, replacing any pending event of the same kind for this fire mode.
+    * This includes an event already due in the current dispatch pass, that has not been dispatched yet.
+    */
+    void Schedule(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event, float Time);
+
+    /**
+    * Cancel pending event of given kind for this fire mode, if any.
+    */
+    void Cancel(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event);
+
+    /**
+    * Dispatch all due events now.
+    */
+    void DispatchDueEvents();
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    int32 FindEvent(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event) const;
+
+    /**
+    * Drop an event of the current dispatch pass that has not been dispatched yet.
+    * Eg. a DelayedFire shot starts a new cooldown, the previous cooldown due in the same pass must not end it.
+    */
+    void DiscardDueEvent(UUR_FireModeBasic* FireMode, EUR_FireScheduleEvent Event);
+
+    /** Pending events, unordered */
+    TArray<FUR_ScheduledFireEvent> Events;
+
+    /** Events being dispatched. Kept around to reuse allocations */
+    TArray<FUR_ScheduledFireEvent> DueEvents;
+};
@@ -86,23 +86,85 @@ void AUR_GameMode::SetPlayerDefaults(APawn* PlayerPawn)
         if (URCharacter->InventoryComponent)
         {
             URCharacter->InventoryComponent->Clear();
+            GiveStartingWeapons(URCharacter);
+        }
+    }
+    Super::SetPlayerDefaults(PlayerPawn);
+}
+
+void AUR_GameMode::GiveStartingWeapons(AUR_Character* URCharacter)
+{
+    FUR_ParkedInventory Parked;
+    if (AController* Controller = URCharacter->GetController())
+    {
+        ParkedInventories.RemoveAndCopyValue(Controller, Parked);
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    SpawnParams.Owner = URCharacter;
+    SpawnParams.Instigator = URCharacter;
+    for (const FStartingWeaponEntry& Entry : StartingWeapons)
+    {
+        AUR_Weapon* StartingWeapon = nullptr;
 
-            FActorSpawnParameters SpawnParams;
-            SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-            SpawnParams.Owner = URCharacter;
-            SpawnParams.Instigator = URCharacter;
-            for (const FStartingWeaponEntry& Entry : StartingWeapons)
+        const int32 ParkedIndex = Parked.Weapons.IndexOfByPredicate([&Entry](const AUR_Weapon* Weapon)
+        {
+            return IsValid(Weapon) && Weapon->GetClass() == Entry.WeaponClass;
+        });
+        if (ParkedIndex != INDEX_NONE)
+        {
+            StartingWeapon = Parked.Weapons[ParkedIndex];
+            Parked.Weapons.RemoveAtSwap(ParkedIndex);
+            StartingWeapon->SetActorLocationAndRotation(URCharacter->GetActorLocation(), URCharacter->GetActorRotation());
+        }
+        else
+        {
+            StartingWeapon = GetWorld()->SpawnActor<AUR_Weapon>(Entry.WeaponClass, URCharacter->GetActorLocation(), URCharacter->GetActorRotation(), SpawnParams);
+        }
+
+        if (StartingWeapon)
+        {
+            StartingWeapon->SetAmmoCount(Entry.Ammo);
+            StartingWeapon->GiveTo(URCharacter);
+        }
+    }
+
+    // Loadout changed, or weapons picked up during last life
+    for (AUR_Weapon* Leftover : Parked.Weapons)
+    {
+        if (IsValid(Leftover))
+        {
+            Leftover->Destroy();
+        }
+    }
+}
+
+void AUR_GameMode::ParkInventory(AController* Victim)
+{
+    AUR_Character* URCharacter = Victim ? Cast<AUR_Character>(Victim->GetPawn()) : nullptr;
+    if (URCharacter && URCharacter->InventoryComponent)
+    {
+        FUR_ParkedInventory& Parked = ParkedInventories.FindOrAdd(Victim);
+        URCharacter->InventoryComponent->ParkWeapons(Parked.Weapons);
+    }
+}
+
+void AUR_GameMode::Logout(AController* Exiting)
+{
+    FUR_ParkedInventory Parked;
+    if (ParkedInventories.RemoveAndCopyValue(Exiting, Parked))
+    {
+        for (AUR_Weapon* Weapon : Parked.Weapons)
+        {
+            if (IsValid(Weapon))
             {
-                AUR_Weapon* StartingWeapon = GetWorld()->SpawnActor<AUR_Weapon>(Entry.WeaponClass, URCharacter->GetActorLocation(), URCharacter->GetActorRotation(), SpawnParams);
-                if (StartingWeapon)
-                {
-                    StartingWeapon->AmmoCount = Entry.Ammo;
-                    StartingWeapon->GiveTo(URCharacter);
-                }
+                Weapon->Destroy();
             }
         }
     }
-    Super::SetPlayerDefaults(PlayerPawn);
+
+    Super::Logout(Exiting);
 }
 
 
@@ -143,6 +205,7 @@ bool AUR_GameMode::PreventDeath_Implementation(AController* Killed, AController*
 void AUR_GameMode::PlayerKilled_Implementation(AController* Victim, AController* Killer, const FDamageEvent& DamageEvent, AActor* DamageCauser)
 {
     RegisterKill(Victim, Killer, DamageEvent, DamageCauser);
+    ParkInventory(Victim);
 }
 
 void AUR_GameMode::RegisterKill(AController* Victim, AController* Killer, const FDamageEvent& DamageEvent, AActor* DamageCauser)
@@ -10,6 +10,7 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+class AUR_Character;
 class AUR_GameState;
 class AUR_Weapon;
 class ULocalMessage;
@@ -29,6 +30,18 @@ struct FStartingWeaponEntry
     int32 Ammo;
 };
 
+/**
+* Weapons taken from a player on death, given back on respawn.
+*/
+USTRUCT()
+struct FUR_ParkedInventory
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<AUR_Weapon*> Weapons;
+};
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -83,6 +96,29 @@ public:
 
     virtual void SetPlayerDefaults(APawn* PlayerPawn) override;
 
+    virtual void Logout(AController* Exiting) override;
+
+    /**
+    * Give starting weapons to a freshly spawned character.
+    * Weapons parked on the player's last death are reset and given back when they match the loadout,
+    * so actors are only spawned (and destroyed) when the loadout actually changes.
+    */
+    virtual void GiveStartingWeapons(AUR_Character* URCharacter);
+
+    /**
+    * Park the victim's weapons until they respawn.
+    */
+    UFUNCTION(BlueprintCallable)
+    virtual void ParkInventory(AController* Victim);
+
+protected:
+
+    /** Weapons parked by ParkInventory, by controller */
+    UPROPERTY(Transient)
+    TMap<AController*, FUR_ParkedInventory> ParkedInventories;
+
+public:
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // Killing
     /////////////////////////////////////////////////////////////////////////////////////////////////
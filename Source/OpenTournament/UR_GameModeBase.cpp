@@ -6,7 +6,10 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
-AUR_GameModeBase::AUR_GameModeBase(){}
+AUR_GameModeBase::AUR_GameModeBase()
+    : MaxLagCompensationTime(0.25f)
+{
+}
 
 void AUR_GameModeBase::RegisterChatComponent(UUR_ChatComponent* Comp)
 {
@@ -18,3 +21,14 @@ void AUR_GameModeBase::UnregisterChatComponent(UUR_ChatComponent* Comp)
 {
 	ChatComponents.Remove(Comp);
 }
+
+void AUR_GameModeBase::RegisterLagCompensationComponent(UUR_LagCompensationComponent* Comp)
+{
+    if (Comp)
+        LagCompensationComponents.AddUnique(Comp);
+}
+
+void AUR_GameModeBase::UnregisterLagCompensationComponent(UUR_LagCompensationComponent* Comp)
+{
+    LagCompensationComponents.Remove(Comp);
+}
@@ -34,4 +34,19 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "Chat")
     virtual void UnregisterChatComponent(class UUR_ChatComponent* Comp);
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * Maximum time (in seconds) authority is allowed to rewind hitboxes when processing client shots.
+    * Client timestamps older than this are clamped.
+    */
+    UPROPERTY(Config, EditDefaultsOnly, BlueprintReadOnly, Category = "Lag Compensation")
+    float MaxLagCompensationTime;
+
+    TArray<class UUR_LagCompensationComponent*> LagCompensationComponents;
+
+    virtual void RegisterLagCompensationComponent(class UUR_LagCompensationComponent* Comp);
+
+    virtual void UnregisterLagCompensationComponent(class UUR_LagCompensationComponent* Comp);
 };
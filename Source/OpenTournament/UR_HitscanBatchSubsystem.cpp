@@ -0,0 +1,164 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_HitscanBatchSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "OpenTournament.h"
+#include "UR_LagCompensationComponent.h"
+#include "UR_Weapon.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Traces Batched"), STAT_OT_HitscanTracesBatched, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Batch Groups"), STAT_OT_HitscanBatchGroups, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Batch Resolve"), STAT_OT_HitscanBatchResolve, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Batch Sweeps"), STAT_OT_HitscanBatchSweeps, STATGROUP_OpenTournament);
+
+static TAutoConsoleVariable<int32> CVarHitscanBatching(
+    TEXT("ot.HitscanBatching"),
+    1,
+    TEXT("Resolve authority hitscan traces in one batch at the end of the frame.\n")
+    TEXT("0: trace immediately when the shot is received\n")
+    TEXT("1: batch (default)"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarHitscanBatchMinParallel(
+    TEXT("ot.HitscanBatchMinParallel"),
+    4,
+    TEXT("Minimum number of traces in a group before sweeps are dispatched to worker threads."),
+    ECVF_Default);
+
+/**
+* Requests whose lag compensation times are within this tolerance share the same hitbox rewind.
+* Server ticks are at least this long, so this does not lose any precision.
+*/
+static const float RewindGroupTolerance = 0.005f;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_HitscanBatchSubsystem::Deinitialize()
+{
+    PendingRequests.Empty();
+    ResolvingRequests.Empty();
+    ScratchHits.Empty();
+
+    Super::Deinitialize();
+}
+
+bool UUR_HitscanBatchSubsystem::IsBatchingEnabled() const
+{
+    return CVarHitscanBatching.GetValueOnGameThread() != 0;
+}
+
+void UUR_HitscanBatchSubsystem::QueueRequest(const FUR_HitscanRequest& Request)
+{
+    PendingRequests.Add(Request);
+}
+
+void UUR_HitscanBatchSubsystem::Flush()
+{
+    if (PendingRequests.Num() == 0)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_OT_HitscanBatchResolve);
+    INC_DWORD_STAT_BY(STAT_OT_HitscanTracesBatched, PendingRequests.Num());
+
+    // Anything queued while resolving (eg. from damage callbacks) goes to the next batch
+    Swap(PendingRequests, ResolvingRequests);
+
+    const int32 Num = ResolvingRequests.Num();
+    if (ScratchHits.Num() < Num)
+    {
+        ScratchHits.SetNum(Num);
+    }
+
+    // Group by rewind time, keeping arrival order within a group
+    ResolvingRequests.StableSort([](const FUR_HitscanRequest& A, const FUR_HitscanRequest& B)
+    {
+        return A.ClientTime < B.ClientTime;
+    });
+
+    UWorld* World = GetWorld();
+    const int32 MinParallel = CVarHitscanBatchMinParallel.GetValueOnGameThread();
+
+    int32 GroupStart = 0;
+    while (GroupStart < Num)
+    {
+        const float GroupTime = ResolvingRequests[GroupStart].ClientTime;
+        int32 GroupEnd = GroupStart + 1;
+        while (GroupEnd < Num && ResolvingRequests[GroupEnd].ClientTime - GroupTime <= RewindGroupTolerance)
+        {
+            GroupEnd++;
+        }
+
+        INC_DWORD_STAT(STAT_OT_HitscanBatchGroups);
+
+        FUR_ScopedLagCompensation LagCompensation(World, GroupTime);
+
+        SCOPE_CYCLE_COUNTER(STAT_OT_HitscanBatchSweeps);
+        const int32 GroupNum = GroupEnd - GroupStart;
+        ParallelFor(GroupNum, [this, World, GroupStart](int32 i)
+        {
+            const FUR_HitscanRequest& Request = ResolvingRequests[GroupStart + i];
+            AUR_Weapon::HitscanSweep(World, Request.TraceStart, Request.TraceEnd, Request.QueryParams, ScratchHits[GroupStart + i]);
+        }, GroupNum < MinParallel);
+
+        GroupStart = GroupEnd;
+    }
+
+    // Hit selection may call into blueprint, and damage modifies actors. Back to sequential.
+    for (int32 i = 0; i < Num; i++)
+    {
+        FUR_HitscanRequest& Request = ResolvingRequests[i];
+        if (AUR_Weapon* Weapon = Request.Weapon.Get())
+        {
+            Weapon->HitscanPickHit(ScratchHits[i], Request.TraceStart, Request.TraceEnd, Request.Hit);
+            Weapon->AuthorityHitscanResolved(Request);
+        }
+        ScratchHits[i].Reset();
+    }
+
+    ResolvingRequests.Reset();
+}
+
+void UUR_HitscanBatchSubsystem::SweepImmediate(const FVector& TraceStart, const TArray<FVector>& TraceEnds, const FCollisionQueryParams& Params, TArray<TArray<FHitResult>>& OutHits) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_HitscanBatchSweeps);
+
+    const int32 Num = TraceEnds.Num();
+    if (OutHits.Num() < Num)
+    {
+        OutHits.SetNum(Num);
+    }
+
+    const UWorld* World = GetWorld();
+    ParallelFor(Num, [World, &TraceStart, &TraceEnds, &Params, &OutHits](int32 i)
+    {
+        OutHits[i].Reset();
+        AUR_Weapon::HitscanSweep(World, TraceStart, TraceEnds[i], Params, OutHits[i]);
+    }, Num < CVarHitscanBatchMinParallel.GetValueOnGameThread());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_HitscanBatchSubsystem::Tick(float DeltaTime)
+{
+    Flush();
+}
+
+ETickableTickType UUR_HitscanBatchSubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_HitscanBatchSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_HitscanBatchSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_HitscanBatchSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AUR_Weapon;
+class UUR_FireModeBase;
+class UDamageType;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* A single authority hitscan trace waiting to be resolved.
+*/
+struct FUR_HitscanRequest
+{
+    TWeakObjectPtr<AUR_Weapon> Weapon;
+
+    TWeakObjectPtr<UUR_FireModeBase> FireMode;
+
+    FVector TraceStart;
+
+    FVector TraceEnd;
+
+    /** Aim direction before spread */
+    FVector AimDir;
+
+    /** Server time seen by the shooter, for lag compensation */
+    float ClientTime;
+
+    float Damage;
+
+    TSubclassOf<UDamageType> DamageType;
+
+    /** Whether the resolved hit should be multicasted as FireModeBasic hitscan visuals */
+    bool bReplicateVisuals;
+
+    /** Sweep params, see AUR_Weapon::GetHitscanQueryParams */
+    FCollisionQueryParams QueryParams;
+
+    /** Filled in when resolved */
+    FHitResult Hit;
+};
+
+/**
+* Collects all authority hitscan traces of a frame, and resolves them in one batch at the end of the frame.
+*
+* - Requests are grouped by lag compensation time, so hitboxes are only rewound once per group.
+*   Unlike FUR_ScopedLagCompensation for a single shot, the shooters of the group are rewound as well.
+*   This is harmless because each sweep ignores its own instigator, see AUR_Weapon::QueueAuthorityHitscan.
+* - Sweeps of a group run in parallel. They are read-only scene queries, actors are not touched.
+* - Hit selection (HitscanShouldHitActor) and damage are then processed on the game thread, in request order.
+*
+* Requests are queued from AUR_Weapon::QueueAuthorityHitscan.
+* Batching can be toggled at runtime with ot.HitscanBatching.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_HitscanBatchSubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Whether new traces should be queued here rather than resolved immediately.
+    */
+    bool IsBatchingEnabled() const;
+
+    /**
+    * Queue a trace to be resolved at the end of the frame.
+    */
+    void QueueRequest(const FUR_HitscanRequest& Request);
+
+    /**
+    * Resolve all pending requests now.
+    */
+    void Flush();
+
+    /**
+    * Sweep several traces sharing the same origin and query params right away, in parallel when worth it.
+    * For multi-trace shots (eg. shotgun pellets) whose results must be processed together.
+    * Caller is responsible for lag compensation.
+    */
+    void SweepImmediate(const FVector& TraceStart, const TArray<FVector>& TraceEnds, const FCollisionQueryParams& Params, TArray<TArray<FHitResult>>& OutHits) const;
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    /** Requests queued during this frame */
+    TArray<FUR_HitscanRequest> PendingRequests;
+
+    /** Requests being resolved. Kept around to reuse allocations */
+    TArray<FUR_HitscanRequest> ResolvingRequests;
+
+    /** Sweep results, one array per request. Kept around to reuse allocations */
+    TArray<TArray<FHitResult>> ScratchHits;
+};
@@ -17,6 +17,8 @@
 UUR_InventoryComponent::UUR_InventoryComponent()
 {
     SetIsReplicatedByDefault(true);
+
+    WeaponGroupSlots.SetNumZeroed(NUM_WEAPON_GROUPS);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -47,21 +49,20 @@ void UUR_InventoryComponent::Add(AUR_Weapon* InWeapon)
     }
 
     // If we already have this weapon class, just stack ammo
-    for (AUR_Weapon* IterWeapon : InventoryW)
+    if (AUR_Weapon** Existing = WeaponsByClass.Find(InWeapon->GetClass()))
     {
-        if (IterWeapon->GetClass() == InWeapon->GetClass())
-        {
-            const int32 NewAmmoCount = IterWeapon->AmmoCount + InWeapon->AmmoCount;
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Blue, FString::Printf(TEXT("%s ammo count %i -> %i"), *IterWeapon->WeaponName, IterWeapon->AmmoCount, NewAmmoCount));
-            IterWeapon->AmmoCount = NewAmmoCount;
-            InWeapon->Destroy();
-            return;
-        }
+        AUR_Weapon* IterWeapon = *Existing;
+        const int32 NewAmmoCount = IterWeapon->AmmoCount + InWeapon->AmmoCount;
+        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Blue, FString::Printf(TEXT("%s ammo count %i -> %i"), *IterWeapon->GetWeaponName(), IterWeapon->AmmoCount, NewAmmoCount));
+        IterWeapon->SetAmmoCount(NewAmmoCount);
+        InWeapon->Destroy();
+        return;
     }
 
     // Else, add weapon
     InventoryW.Add(InWeapon);
-    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("You have the %s (ammo = %i)"), *InWeapon->WeaponName, InWeapon->AmmoCount));
+    IndexWeapon(InWeapon);
+    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("You have the %s (ammo = %i)"), *InWeapon->GetWeaponName(), InWeapon->AmmoCount));
 
     // In standalone or listen host, call OnRep next tick so we can pick amongst new weapons what to swap to.
     if (IsLocallyControlled())
@@ -70,6 +71,127 @@ void UUR_InventoryComponent::Add(AUR_Weapon* InWeapon)
     }
 }
 
+void UUR_InventoryComponent::Remove(AUR_Weapon* InWeapon)
+{
+    if (!InWeapon)
+    {
+        return;
+    }
+
+    InventoryW.Remove(InWeapon);
+    UnindexWeapon(InWeapon);
+
+    if (ActiveWeapon == InWeapon)
+    {
+        ActiveWeapon->OnWeaponStateChanged.RemoveDynamic(this, &UUR_InventoryComponent::OnActiveWeaponStateChanged);
+        ActiveWeapon = nullptr;
+    }
+    if (DesiredWeapon == InWeapon)
+    {
+        DesiredWeapon = nullptr;
+    }
+}
+
+void UUR_InventoryComponent::ParkWeapons(TArray<AUR_Weapon*>& OutParkedWeapons)
+{
+    // Park() removes the weapon from InventoryW
+    const TArray<AUR_Weapon*> Weapons = InventoryW;
+    for (AUR_Weapon* IterWeapon : Weapons)
+    {
+        if (IterWeapon && !IterWeapon->IsPendingKillPending())
+        {
+            IterWeapon->Park();
+            OutParkedWeapons.Add(IterWeapon);
+        }
+    }
+    InventoryW.Empty();
+    ReindexWeapons();
+}
+
+void UUR_InventoryComponent::IndexWeapon(AUR_Weapon* InWeapon)
+{
+    WeaponsByClass.Add(InWeapon->GetClass(), InWeapon);
+
+    const int32 Group = FMath::Clamp(InWeapon->GetWeaponGroup(), 0, NUM_WEAPON_GROUPS - 1);
+    for (int32 i = 0; i < NUM_WEAPON_GROUPS; i++)
+    {
+        AUR_Weapon*& Slot = WeaponGroupSlots[(Group + i) % NUM_WEAPON_GROUPS];
+        if (!Slot)
+        {
+            Slot = InWeapon;
+            return;
+        }
+    }
+}
+
+void UUR_InventoryComponent::UnindexWeapon(AUR_Weapon* InWeapon)
+{
+    if (WeaponsByClass.FindRef(InWeapon->GetClass()) == InWeapon)
+    {
+        WeaponsByClass.Remove(InWeapon->GetClass());
+    }
+
+    const int32 Slot = FindWeaponSlot(InWeapon);
+    if (Slot != INDEX_NONE)
+    {
+        WeaponGroupSlots[Slot] = nullptr;
+    }
+}
+
+void UUR_InventoryComponent::ReindexWeapons()
+{
+    WeaponsByClass.Reset();
+    for (AUR_Weapon*& Slot : WeaponGroupSlots)
+    {
+        Slot = nullptr;
+    }
+
+    for (AUR_Weapon* IterWeapon : InventoryW)
+    {
+        if (IterWeapon)
+        {
+            IndexWeapon(IterWeapon);
+        }
+    }
+}
+
+int32 UUR_InventoryComponent::FindWeaponSlot(const AUR_Weapon* InWeapon) const
+{
+    if (!InWeapon)
+    {
+        return INDEX_NONE;
+    }
+
+    // Usually in its own group
+    const int32 Group = FMath::Clamp(InWeapon->GetWeaponGroup(), 0, NUM_WEAPON_GROUPS - 1);
+    for (int32 i = 0; i < NUM_WEAPON_GROUPS; i++)
+    {
+        const int32 Slot = (Group + i) % NUM_WEAPON_GROUPS;
+        if (WeaponGroupSlots[Slot] == InWeapon)
+        {
+            return Slot;
+        }
+    }
+    return INDEX_NONE;
+}
+
+AUR_Weapon* UUR_InventoryComponent::CycleWeapon(int32 Direction) const
+{
+    const int32 Start = FindWeaponSlot(DesiredWeapon);
+    for (int32 i = 1; i <= NUM_WEAPON_GROUPS; i++)
+    {
+        // Without desired weapon, start from the first (or last) group
+        const int32 Slot = (Start != INDEX_NONE)
+            ? (Start + Direction * i + NUM_WEAPON_GROUPS) % NUM_WEAPON_GROUPS
+            : (Direction > 0 ? i - 1 : NUM_WEAPON_GROUPS - i);
+        if (WeaponGroupSlots[Slot])
+        {
+            return WeaponGroupSlots[Slot];
+        }
+    }
+    return nullptr;
+}
+
 void UUR_InventoryComponent::Add(AUR_Ammo* InAmmo)
 {
     /*if (InventoryA.Contains(ammo)) {
@@ -115,7 +237,7 @@ void UUR_InventoryComponent::ShowInventory()
 {
     for (auto& IterWeapon : InventoryW)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, FString::Printf(TEXT("Weapons in inventory: %s with Ammo Count: %d"), *IterWeapon->WeaponName, IterWeapon->AmmoCount));
+        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, FString::Printf(TEXT("Weapons in inventory: %s with Ammo Count: %d"), *IterWeapon->GetWeaponName(), IterWeapon->AmmoCount));
     }
 
     for (auto& IterAmmo : InventoryA)
@@ -127,63 +249,30 @@ void UUR_InventoryComponent::ShowInventory()
 
 int32 UUR_InventoryComponent::SelectWeapon(int32 WeaponGroup)
 {
-    FString DesiredWeaponName = (TArray<FString> {
-        TEXT("Assault Rifle"),
-        TEXT("Shotgun"),
-        TEXT("Rocket Launcher"),
-        TEXT("Grenade Launcher"),
-        TEXT("Sniper Rifle"),
-        TEXT("Pistol"),
-    })[WeaponGroup];
-
-    for (auto& IterWeapon : InventoryW)
+    if (WeaponGroupSlots.IsValidIndex(WeaponGroup) && WeaponGroupSlots[WeaponGroup])
     {
-        if (IterWeapon->WeaponName == DesiredWeaponName)
-        {
-            SetDesiredWeapon(IterWeapon);
-            return WeaponGroup;
-        }
+        SetDesiredWeapon(WeaponGroupSlots[WeaponGroup]);
+        return WeaponGroup;
     }
     return 0;
 }
 
 AUR_Weapon * UUR_InventoryComponent::SelectWeaponG(int32 WeaponGroup)
 {
-    FString DesiredWeaponName = (TArray<FString> {
-        TEXT("Assault Rifle"),
-        TEXT("Shotgun"),
-        TEXT("Rocket Launcher"),
-        TEXT("Grenade Launcher"),
-        TEXT("Sniper Rifle"),
-        TEXT("Pistol"),
-    })[WeaponGroup];
-
-    for (auto& IterWeapon : InventoryW)
+    if (WeaponGroupSlots.IsValidIndex(WeaponGroup) && WeaponGroupSlots[WeaponGroup])
     {
-        if (IterWeapon->WeaponName == DesiredWeaponName)
-        {
-            SetDesiredWeapon(IterWeapon);
-            break;
-        }
+        SetDesiredWeapon(WeaponGroupSlots[WeaponGroup]);
     }
     return ActiveWeapon;
 }
 
 bool UUR_InventoryComponent::NextWeapon()
 {
-    AUR_Weapon* NewWeapon = nullptr;
-
-    for (int32 i = 0; i < InventoryW.Num(); i++)
-    {
-        if (InventoryW[i] == DesiredWeapon)
-            NewWeapon = InventoryW[(i + 1) % InventoryW.Num()];
-    }
-    if (!NewWeapon && InventoryW.Num() > 0)
-        NewWeapon = InventoryW[0];
+    AUR_Weapon* NewWeapon = CycleWeapon(1);
 
     if (NewWeapon && NewWeapon != DesiredWeapon)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("Next weapon -> %s"), *NewWeapon->WeaponName));
+        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("Next weapon -> %s"), *NewWeapon->GetWeaponName()));
         SetDesiredWeapon(NewWeapon);
         return true;
     }
@@ -192,19 +281,11 @@ bool UUR_InventoryComponent::NextWeapon()
 
 bool UUR_InventoryComponent::PrevWeapon()
 {
-    AUR_Weapon* NewWeapon = nullptr;
-
-    for (int32 i = 0; i < InventoryW.Num(); i++)
-    {
-        if (InventoryW[i] == DesiredWeapon)
-            NewWeapon = InventoryW[(i + InventoryW.Num() - 1) % InventoryW.Num()];
-    }
-    if (!NewWeapon && InventoryW.Num() > 0)
-        NewWeapon = InventoryW.Last();
+    AUR_Weapon* NewWeapon = CycleWeapon(-1);
 
     if (NewWeapon && NewWeapon != DesiredWeapon)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("Prev weapon -> %s"), *NewWeapon->WeaponName));
+        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("Prev weapon -> %s"), *NewWeapon->GetWeaponName()));
         SetDesiredWeapon(NewWeapon);
         return true;
     }
@@ -291,6 +372,12 @@ void UUR_InventoryComponent::SetActiveWeapon(AUR_Weapon* InWeapon)
 
 void UUR_InventoryComponent::OnRep_InventoryW()
 {
+    // Owning client, lookup tables follow replicated inventory
+    if (GetNetMode() == NM_Client)
+    {
+        ReindexWeapons();
+    }
+
     if (!ActiveWeapon)
     {
         // This should only happen when we are given initial inventory on spawn
@@ -327,6 +414,7 @@ void UUR_InventoryComponent::Clear_Implementation()
             IterWeapon->Destroy();
     }
     InventoryW.Empty();
+    ReindexWeapons();
 
     for (AUR_Ammo* IterAmmo : InventoryA)
     {
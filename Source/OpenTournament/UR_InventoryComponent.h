@@ -20,6 +20,11 @@ class AUR_Weapon;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+/** Number of weapon selection groups, one per number key */
+#define NUM_WEAPON_GROUPS 10
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
 
 /**
  * InventoryComponent is the base component for use by actors to have an inventory.
@@ -60,6 +65,17 @@ public:
 
     void Add(AUR_Weapon* InWeapon);
 
+    /**
+    * Remove a weapon from the inventory without destroying it.
+    */
+    void Remove(AUR_Weapon* InWeapon);
+
+    /**
+    * Park all weapons (see AUR_Weapon::Park) and empty the inventory.
+    * Parked weapons are returned so they can be given again on respawn.
+    */
+    void ParkWeapons(TArray<AUR_Weapon*>& OutParkedWeapons);
+
     void Add(AUR_Ammo* InAmmo);
 
     void AmmoCountInInventory(AUR_Weapon* InWeapon);
@@ -102,6 +118,35 @@ public:
 
 protected:
 
+    /**
+    * Weapon of each selection group, maintained alongside InventoryW.
+    * Always NUM_WEAPON_GROUPS entries, empty groups are null. Used for constant-time selection and cycling.
+    */
+    UPROPERTY(Transient)
+    TArray<AUR_Weapon*> WeaponGroupSlots;
+
+    /** Weapon of each class in InventoryW, for ammo stacking */
+    UPROPERTY(Transient)
+    TMap<UClass*, AUR_Weapon*> WeaponsByClass;
+
+    /**
+    * Slot a weapon in the lookup tables. Takes the next free group if its own is taken.
+    */
+    void IndexWeapon(AUR_Weapon* InWeapon);
+
+    void UnindexWeapon(AUR_Weapon* InWeapon);
+
+    /** Rebuild lookup tables from InventoryW */
+    void ReindexWeapons();
+
+    /** Group slot holding given weapon, or INDEX_NONE */
+    int32 FindWeaponSlot(const AUR_Weapon* InWeapon) const;
+
+    /**
+    * Next (or previous) occupied group slot after the desired weapon's, wrapping around.
+    */
+    AUR_Weapon* CycleWeapon(int32 Direction) const;
+
     UFUNCTION()
     virtual void OnRep_InventoryW();
 
@@ -0,0 +1,238 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_LagCompensationComponent.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "PhysicsEngine/BodyInstance.h"
+
+#include "UR_GameModeBase.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+UUR_LagCompensationComponent::UUR_LagCompensationComponent()
+    : NewestPoseIndex(-1)
+    , NumPoses(0)
+    , bIsRewound(false)
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
+    // Record poses after movement has been applied
+    PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void UUR_LagCompensationComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // No point in rewinding anything in standalone
+    if (GetNetMode() == NM_Standalone)
+    {
+        return;
+    }
+
+    if (AUR_GameModeBase* URGameMode = GetWorld()->GetAuthGameMode<AUR_GameModeBase>())
+    {
+        URGameMode->RegisterLagCompensationComponent(this);
+        RecordPose(GetWorld()->GetTimeSeconds());
+        SetComponentTickEnabled(true);
+    }
+}
+
+void UUR_LagCompensationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Super::EndPlay(EndPlayReason);
+
+    if (AUR_GameModeBase* URGameMode = GetWorld()->GetAuthGameMode<AUR_GameModeBase>())
+    {
+        URGameMode->UnregisterLagCompensationComponent(this);
+    }
+}
+
+void UUR_LagCompensationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    RecordPose(GetWorld()->GetTimeSeconds());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_LagCompensationComponent::RecordPose(float Time)
+{
+    const USceneComponent* Root = GetOwner() ? GetOwner()->GetRootComponent() : nullptr;
+    if (!Root || bIsRewound)
+    {
+        return;
+    }
+
+    NewestPoseIndex = (NewestPoseIndex + 1) % LAGCOMP_MAX_SAMPLES;
+    SavedPoses[NewestPoseIndex].Time = Time;
+    SavedPoses[NewestPoseIndex].Transform = Root->GetComponentTransform();
+    NumPoses = FMath::Min(NumPoses + 1, LAGCOMP_MAX_SAMPLES);
+}
+
+bool UUR_LagCompensationComponent::GetPoseAtTime(float Time, FTransform& OutTransform) const
+{
+    if (NumPoses <= 0)
+    {
+        return false;
+    }
+
+    // Walk history from newest to oldest, until we find the sample right before Time
+    for (int32 i = 0; i < NumPoses; i++)
+    {
+        const int32 Index = (NewestPoseIndex - i + LAGCOMP_MAX_SAMPLES) % LAGCOMP_MAX_SAMPLES;
+        const FSavedHitboxPose& Older = SavedPoses[Index];
+        if (Older.Time <= Time)
+        {
+            if (i == 0)
+            {
+                // More recent than our newest sample
+                OutTransform = Older.Transform;
+                return true;
+            }
+
+            const FSavedHitboxPose& Newer = SavedPoses[(Index + 1) % LAGCOMP_MAX_SAMPLES];
+            const float Alpha = (Newer.Time > Older.Time) ? (Time - Older.Time) / (Newer.Time - Older.Time) : 1.f;
+            OutTransform.Blend(Older.Transform, Newer.Transform, Alpha);
+            return true;
+        }
+    }
+
+    // Older than our oldest sample
+    const int32 OldestIndex = (NewestPoseIndex - NumPoses + 1 + LAGCOMP_MAX_SAMPLES) % LAGCOMP_MAX_SAMPLES;
+    OutTransform = SavedPoses[OldestIndex].Transform;
+    return true;
+}
+
+void UUR_LagCompensationComponent::RewindHitboxes(float Time)
+{
+    const USceneComponent* Root = GetOwner() ? GetOwner()->GetRootComponent() : nullptr;
+    if (!Root || bIsRewound)
+    {
+        return;
+    }
+
+    FTransform Pose;
+    if (!GetPoseAtTime(Time, Pose))
+    {
+        return;
+    }
+
+    PreRewindPose = Root->GetComponentTransform();
+    if (Pose.Equals(PreRewindPose, 0.1f))
+    {
+        return;
+    }
+
+    RewoundPose = Pose;
+    MoveHitboxBodies(PreRewindPose, RewoundPose);
+    bIsRewound = true;
+}
+
+void UUR_LagCompensationComponent::RestoreHitboxes()
+{
+    if (bIsRewound)
+    {
+        MoveHitboxBodies(RewoundPose, PreRewindPose);
+        bIsRewound = false;
+    }
+}
+
+void UUR_LagCompensationComponent::MoveHitboxBodies(const FTransform& FromPose, const FTransform& ToPose)
+{
+    const auto MoveBody = [&FromPose, &ToPose](FBodyInstance* Body)
+    {
+        if (Body && Body->IsValidBodyInstance())
+        {
+            const FTransform BodyTransform = Body->GetUnrealWorldTransform();
+            Body->SetBodyTransform(BodyTransform.GetRelativeTransform(FromPose) * ToPose, ETeleportType::TeleportPhysics);
+        }
+    };
+
+    TInlineComponentArray<UPrimitiveComponent*> Primitives(GetOwner());
+    for (UPrimitiveComponent* Primitive : Primitives)
+    {
+        if (!Primitive->IsQueryCollisionEnabled())
+        {
+            continue;
+        }
+
+        if (USkeletalMeshComponent* SkelMesh = Cast<USkeletalMeshComponent>(Primitive))
+        {
+            for (FBodyInstance* Body : SkelMesh->Bodies)
+            {
+                MoveBody(Body);
+            }
+        }
+        else
+        {
+            MoveBody(Primitive->GetBodyInstance());
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+FUR_ScopedLagCompensation::FUR_ScopedLagCompensation(const AActor* Shooter, float ClientTime)
+    : GameMode(nullptr)
+    , IgnoredActor(Shooter)
+{
+    Rewind(Shooter ? Shooter->GetWorld() : nullptr, ClientTime);
+}
+
+FUR_ScopedLagCompensation::FUR_ScopedLagCompensation(UWorld* World, float ClientTime)
+    : GameMode(nullptr)
+    , IgnoredActor(nullptr)
+{
+    Rewind(World, ClientTime);
+}
+
+void FUR_ScopedLagCompensation::Rewind(UWorld* World, float ClientTime)
+{
+    if (!World || World->GetNetMode() == NM_Standalone || World->GetNetMode() == NM_Client)
+    {
+        return;
+    }
+
+    AUR_GameModeBase* URGameMode = World->GetAuthGameMode<AUR_GameModeBase>();
+    if (!URGameMode || URGameMode->LagCompensationComponents.Num() == 0)
+    {
+        return;
+    }
+
+    const float Now = World->GetTimeSeconds();
+    const float RewindTime = FMath::Clamp(ClientTime, Now - URGameMode->MaxLagCompensationTime, Now);
+    if (Now - RewindTime < 0.001f)
+    {
+        return;
+    }
+
+    GameMode = URGameMode;
+    for (UUR_LagCompensationComponent* Comp : GameMode->LagCompensationComponents)
+    {
+        if (Comp && Comp->GetOwner() != IgnoredActor)
+        {
+            Comp->RewindHitboxes(RewindTime);
+        }
+    }
+}
+
+FUR_ScopedLagCompensation::~FUR_ScopedLagCompensation()
+{
+    if (GameMode)
+    {
+        for (UUR_LagCompensationComponent* Comp : GameMode->LagCompensationComponents)
+        {
+            if (Comp)
+            {
+                Comp->RestoreHitboxes();
+            }
+        }
+    }
+}
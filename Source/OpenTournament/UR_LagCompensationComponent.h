@@ -0,0 +1,142 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "UR_LagCompensationComponent.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AActor;
+class AUR_GameModeBase;
+class UWorld;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Number of hitbox poses stored per character.
+* At 30Hz server tick this covers about 2 seconds of history, far above any sensible rewind window.
+*/
+#define LAGCOMP_MAX_SAMPLES 64
+
+/**
+* Hitbox pose at a given server time.
+*/
+struct FSavedHitboxPose
+{
+    float Time;
+    FTransform Transform;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Server-side lag compensation.
+*
+* Records a short history of the owner's hitbox (capsule) transform every server tick, in a fixed-size ring buffer.
+* When authority processes a hitscan shot, hitboxes of all registered actors are rewound
+* to the server time the shooter was seeing when firing, the trace is performed, and hitboxes are restored.
+*
+* Rewinding only moves the physics bodies used by scene queries.
+* Components are not moved, so no overlap events, movement or replication is affected.
+*
+* Components register to the GameMode, so this does nothing on clients.
+*/
+UCLASS(ClassGroup = (Custom), Meta = (BlueprintSpawnableComponent))
+class OPENTOURNAMENT_API UUR_LagCompensationComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+
+    UUR_LagCompensationComponent();
+
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    /**
+    * Store current hitbox pose into history.
+    */
+    void RecordPose(float Time);
+
+    /**
+    * Retrieve interpolated hitbox pose at the given time.
+    * Returns false if no history is available.
+    */
+    bool GetPoseAtTime(float Time, FTransform& OutTransform) const;
+
+    /**
+    * Move hitbox physics bodies to the pose stored at given time.
+    * Must be followed by a call to RestoreHitboxes().
+    */
+    void RewindHitboxes(float Time);
+
+    /**
+    * Move hitbox physics bodies back to their current pose.
+    */
+    void RestoreHitboxes();
+
+    UFUNCTION(BlueprintCallable, BlueprintPure)
+    FORCEINLINE bool IsRewound() const { return bIsRewound; }
+
+protected:
+
+    /**
+    * Apply a relative offset (from current pose to target pose) to all hitbox bodies of the owner.
+    */
+    void MoveHitboxBodies(const FTransform& FromPose, const FTransform& ToPose);
+
+    FSavedHitboxPose SavedPoses[LAGCOMP_MAX_SAMPLES];
+
+    /** Index of the most recent sample */
+    int32 NewestPoseIndex;
+
+    /** Number of valid samples */
+    int32 NumPoses;
+
+    /** Current pose saved before rewind */
+    FTransform PreRewindPose;
+
+    /** Rewound pose currently applied to bodies */
+    FTransform RewoundPose;
+
+    bool bIsRewound;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Helper scope to rewind all lag compensated actors for the duration of the scope.
+*
+* Usage (authority only) :
+* {
+*     FUR_ScopedLagCompensation LagCompensation(Shooter, SimulatedInfo.ClientTime);
+*     HitscanTrace(...);
+* }
+*
+* The requested time is clamped by the GameMode's MaxLagCompensationTime.
+* Does nothing in standalone, or when the shooter's time is (nearly) the current time, eg. listen server host.
+*
+* The second constructor rewinds everything, including shooters.
+* This is meant for batched traces, where shooters are filtered out by the hit selection anyways.
+*/
+struct OPENTOURNAMENT_API FUR_ScopedLagCompensation
+{
+    FUR_ScopedLagCompensation(const AActor* Shooter, float ClientTime);
+    FUR_ScopedLagCompensation(UWorld* World, float ClientTime);
+    ~FUR_ScopedLagCompensation();
+
+private:
+
+    void Rewind(UWorld* World, float ClientTime);
+
+    AUR_GameModeBase* GameMode;
+
+    const AActor* IgnoredActor;
+};
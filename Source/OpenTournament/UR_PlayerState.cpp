@@ -6,6 +6,8 @@
 
 #include "Net/UnrealNetwork.h"
 
+#include "OpenTournament.h"
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 AUR_PlayerState::AUR_PlayerState()
@@ -16,9 +18,19 @@ void AUR_PlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutL
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(AUR_PlayerState, Kills);
-    DOREPLIFETIME(AUR_PlayerState, Deaths);
-    DOREPLIFETIME(AUR_PlayerState, Suicides);
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(AUR_PlayerState, Kills, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(AUR_PlayerState, Deaths, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(AUR_PlayerState, Suicides, Params);
+}
+
+void AUR_PlayerState::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+    Super::PreReplication(ChangedPropertyTracker);
+
+    // Kills, Deaths, Suicides
+    GamePushModelNetUpdate(this, 3);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +38,7 @@ void AUR_PlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutL
 void AUR_PlayerState::AddKill(AController* Victim)
 {
     Kills++;
+    GAME_MARK_PROPERTY_DIRTY(AUR_PlayerState, Kills, this);
 
     //TODO: count multi kills here
     //TODO: count sprees here
@@ -35,6 +48,7 @@ void AUR_PlayerState::AddKill(AController* Victim)
 void AUR_PlayerState::AddDeath(AController* Killer)
 {
     Deaths++;
+    GAME_MARK_PROPERTY_DIRTY(AUR_PlayerState, Deaths, this);
 
     //TODO: spree ended by killer here
 }
@@ -42,10 +56,12 @@ void AUR_PlayerState::AddDeath(AController* Killer)
 void AUR_PlayerState::AddSuicide()
 {
     Suicides++;
+    GAME_MARK_PROPERTY_DIRTY(AUR_PlayerState, Suicides, this);
 }
 
 void AUR_PlayerState::AddScore(const int32 Value)
 {
+    // Score belongs to APlayerState, SetScore marks it dirty
     SetScore(GetScore() + Value);
     ForceNetUpdate();
 }
@@ -24,9 +24,12 @@ class OPENTOURNAMENT_API AUR_PlayerState : public APlayerState
 protected:
 
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
 public:
 
+    // Push model replicated, only change through the Add functions below
+
     UPROPERTY(Replicated, BlueprintReadOnly)
     int32 Kills;
 
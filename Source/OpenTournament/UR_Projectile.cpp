@@ -11,7 +11,34 @@
 #include "Particles/ParticleSystemComponent.h"
 #include "GameFramework/DamageType.h"
 #include "Kismet/GameplayStatics.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
 #include "Net/UnrealNetwork.h"
+#include "Components/CapsuleComponent.h"
+#include "TimerManager.h"
+
+#include "OpenTournament.h"
+#include "UR_ProjectileBatchSubsystem.h"
+#include "UR_ProjectilePoolSubsystem.h"
+#include "UR_ProjectilePredictionSubsystem.h"
+#include "UR_ReplicationGraph.h"
+#include "UR_DamageableRegistrySubsystem.h"
+#include "UR_CosmeticEventSubsystem.h"
+#include "UR_Weapon.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Analytic Flight Plans"), STAT_OT_AnalyticFlightPlans, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Analytic Flight Confirms"), STAT_OT_AnalyticFlightConfirms, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Analytic Flight"), STAT_OT_AnalyticFlight, STATGROUP_OpenTournament);
+
+/**
+* Targets are snapshot with their current velocity for the whole look ahead window.
+* Those further away than this speed can cover during the window are not considered.
+*/
+static const float AnalyticMaxTargetSpeed = 3000.f;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -52,6 +79,29 @@ AUR_Projectile::AUR_Projectile(const FObjectInitializer& ObjectInitializer)
 
     bReplicates = true;
     bCutReplicationAfterSpawn = false;
+    bReplicateAsEvents = false;
+    NetRelevancyDistance = 10000.f;
+    PredictableNetUpdateFrequency = 10.f;
+    bReplicatedOnce = false;
+
+    PoolWarmUpCount = 4;
+    bPooled = false;
+    bInPool = false;
+
+    bBatchedSimulation = false;
+    bAnalyticFlight = false;
+    AnalyticLookAheadTime = 0.1f;
+    bBatchSimulated = false;
+
+    ShotId = 0;
+    bFakeProjectile = false;
+    PredictionBlendTime = 0.2f;
+    MaxFastForwardTime = 0.25f;
+    SpawnFastForwardTime = 0.f;
+    EventId = 0;
+    PredictionOffset = FVector::ZeroVector;
+    PredictionBlendRemaining = 0.f;
+    bImpactPredicted = false;
 
     BaseDamage = 100.f;
     SplashRadius = 0.0f;
@@ -70,6 +120,7 @@ void AUR_Projectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
     DOREPLIFETIME_CONDITION(AUR_Projectile, ServerExplosionInfo, COND_None);
+    DOREPLIFETIME_CONDITION(AUR_Projectile, ShotId, COND_OwnerOnly);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -84,6 +135,99 @@ void AUR_Projectile::BeginPlay()
     {
         ProjectileMovementComponent->OnProjectileBounce.AddDynamic(this, &AUR_Projectile::OnBounceInternal);
     }
+
+    // Let hitscan queries skip us without even reporting the overlap
+    if (!CanBeDamaged())
+    {
+        CollisionComponent->SetMaskFilterOnBodyInstance(MASKFILTER_HITSCAN_IGNORE);
+    }
+
+    if (!HasAuthority())
+    {
+        InitReplicatedProjectile();
+    }
+    else if (bReplicateAsEvents && GetIsReplicated())
+    {
+        // Replicated through the weapon instead
+        SetReplicates(false);
+    }
+
+    if (SpawnFastForwardTime > 0.f)
+    {
+        FastForward(SpawnFastForwardTime);
+        SpawnFastForwardTime = 0.f;
+    }
+
+    if (CanUseAnalyticFlight() && GetNetMode() != NM_Client && !bFakeProjectile && !IsActorBeingDestroyed())
+    {
+        StartAnalyticFlight();
+    }
+
+    UUR_ProjectileBatchSubsystem* BatchSubsystem = GetWorld()->GetSubsystem<UUR_ProjectileBatchSubsystem>();
+    if (BatchSubsystem && BatchSubsystem->CanSimulate(this) && !IsActorBeingDestroyed())
+    {
+        BatchSubsystem->AddProxy(this);
+    }
+}
+
+void AUR_Projectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    bBatchSimulated = false;
+
+    if (bPooled)
+    {
+        if (UUR_ProjectilePoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UUR_ProjectilePoolSubsystem>())
+        {
+            PoolSubsystem->NotifyProjectileDestroyed(this);
+        }
+        bPooled = false;
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AUR_Projectile::LifeSpanExpired()
+{
+    // Covers both the delayed destroy after exploding, and InitialLifeSpan
+    if (bPooled && HasAuthority())
+    {
+        if (UUR_ProjectilePoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UUR_ProjectilePoolSubsystem>())
+        {
+            PoolSubsystem->Release(this);
+            return;
+        }
+    }
+
+    Super::LifeSpanExpired();
+}
+
+void AUR_Projectile::PostInitProperties()
+{
+    Super::PostInitProperties();
+
+    // Further away, neither the projectile nor its explosion matter to the viewer.
+    // AActor::IsNetRelevantFor still lets the owner and instigator through at any distance.
+    NetCullDistanceSquared = FMath::Square(NetRelevancyDistance + SplashRadius);
+}
+
+void AUR_Projectile::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+    Super::PreReplication(ChangedPropertyTracker);
+
+    if (!bReplicatedOnce)
+    {
+        bReplicatedOnce = true;
+    }
+    else if (NetUpdateFrequency > PredictableNetUpdateFrequency && HasPredictableTrajectory())
+    {
+        NetUpdateFrequency = PredictableNetUpdateFrequency;
+        UUR_ReplicationGraph::NotifyNetUpdateFrequencyChanged(this);
+    }
+}
+
+bool AUR_Projectile::HasPredictableTrajectory() const
+{
+    return !ProjectileMovementComponent->bShouldBounce && !ProjectileMovementComponent->bIsHomingProjectile;
 }
 
 //deprecated
@@ -140,9 +284,11 @@ void AUR_Projectile::OnBounceInternal(const FHitResult& ImpactResult, const FVec
     float BounceNormalVelocity = FMath::Abs(FVector::DotProduct(ImpactVelocity, ImpactResult.Normal));
     if (GetNetMode() != NM_DedicatedServer && BounceNormalVelocity > BounceSoundVelocityThreshold)
     {
-        //TODO: attenuation & concurrency settings, unless we do that in BP/SoundCue?
         //TODO: might want to factor BounceNormalVelocity into the sound somehow
-        UGameplayStatics::PlaySoundAtLocation(this, BounceSound, ImpactResult.Location);
+        if (UUR_CosmeticEventSubsystem* Cosmetics = GetWorld()->GetSubsystem<UUR_CosmeticEventSubsystem>())
+        {
+            Cosmetics->PlaySoundAtLocation(BounceSound, ImpactResult.Location);
+        }
     }
 
     if (bCollideInstigatorAfterBounce && bIgnoreInstigator)
@@ -185,14 +331,32 @@ bool AUR_Projectile::HitShouldExplodeOn_Implementation(AActor* Other)
 
 void AUR_Projectile::DealPointDamage(AActor* HitActor, const FHitResult& HitInfo)
 {
+    if (bFakeProjectile)
+    {
+        return;
+    }
+
     UGameplayStatics::ApplyPointDamage(HitActor, BaseDamage, GetActorRotation().Vector(), HitInfo, GetInstigatorController(), this, DamageTypeClass);
 }
 
 void AUR_Projectile::DealSplashDamage()
 {
+    if (bFakeProjectile)
+    {
+        return;
+    }
+
     TArray<AActor*> IgnoreActors;
     IgnoreActors.Add(this);
 
+    UUR_DamageableRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UUR_DamageableRegistrySubsystem>();
+    if (Registry && Registry->IsBroadphaseEnabled())
+    {
+        Registry->ApplyRadialDamageWithFalloff(BaseDamage, SplashMinimumDamage, GetActorLocation(), InnerSplashRadius, SplashRadius, SplashFalloff,
+            DamageTypeClass, IgnoreActors, this, GetInstigatorController(), ECollisionChannel::ECC_Visibility);
+        return;
+    }
+
     UGameplayStatics::ApplyRadialDamageWithFalloff(
         this,
         BaseDamage,
@@ -211,13 +375,39 @@ void AUR_Projectile::DealSplashDamage()
 
 void AUR_Projectile::Explode(const FVector& HitLocation, const FVector& HitNormal)
 {
-    PlayImpactEffects(HitLocation, HitNormal);
+    bBatchSimulated = false;
+    GetWorldTimerManager().ClearTimer(AnalyticTimerHandle);
+
+    // Skip effects if our fake projectile played them already, at about the same place
+    if (!bImpactPredicted || !HitLocation.Equals(PredictedImpactLocation, 200.f))
+    {
+        PlayImpactEffects(HitLocation, HitNormal);
+    }
 
-    if (HasAuthority())
+    if (bFakeProjectile)
+    {
+        if (UUR_ProjectilePredictionSubsystem* Prediction = GetWorld()->GetSubsystem<UUR_ProjectilePredictionSubsystem>())
+        {
+            Prediction->NotifyFakeExploded(this);
+        }
+        Destroy();
+    }
+    else if (HasAuthority())
     {
-        ServerExplosionInfo.HitLocation = HitLocation;
-        ServerExplosionInfo.HitNormal = HitNormal;
-        ForceNetUpdate();
+        if (bReplicateAsEvents)
+        {
+            if (AUR_Weapon* Weapon = EventWeapon.Get())
+            {
+                Weapon->AuthorityProjectileDetonated(EventId, HitLocation, HitNormal);
+            }
+            EventWeapon = nullptr;
+        }
+        else
+        {
+            ServerExplosionInfo.HitLocation = HitLocation;
+            ServerExplosionInfo.HitNormal = HitNormal;
+            ForceNetUpdate();
+        }
 
         SetActorEnableCollision(false);
         ProjectileMovementComponent->StopSimulating(FHitResult());
@@ -234,13 +424,406 @@ void AUR_Projectile::PlayImpactEffects_Implementation(const FVector& HitLocation
 {
     if (GetNetMode() != NM_DedicatedServer)
     {
-        //TODO: attenuation & concurrency settings, unless we do that in BP/SoundCue?
-        UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, HitLocation);
+        if (UUR_CosmeticEventSubsystem* Cosmetics = GetWorld()->GetSubsystem<UUR_CosmeticEventSubsystem>())
+        {
+            Cosmetics->PlayImpact(ImpactTemplate, ImpactSound, FTransform(HitNormal.Rotation(), HitLocation, GetActorScale3D()));
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AUR_Projectile::OnAcquiredFromPool(const FVector& Location, const FRotator& Rotation)
+{
+    const AUR_Projectile* Defaults = GetClass()->GetDefaultObject<AUR_Projectile>();
+
+    bInPool = false;
+    bIgnoreInstigator = Defaults->bIgnoreInstigator;
+    ShotId = 0;
+    ServerExplosionInfo = FReplicatedExplosionInfo();
+
+    SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+    SetActorHiddenInGame(false);
+    SetActorEnableCollision(Defaults->GetActorEnableCollision());
+
+    // Restart movement the same way UProjectileMovementComponent::InitializeComponent does on spawn
+    ProjectileMovementComponent->SetUpdatedComponent(CollisionComponent);
+    FVector Velocity = Defaults->ProjectileMovementComponent->Velocity;
+    if (ProjectileMovementComponent->InitialSpeed > 0.f)
+    {
+        Velocity = Velocity.GetSafeNormal() * ProjectileMovementComponent->InitialSpeed;
+    }
+    if (ProjectileMovementComponent->bInitialVelocityInLocalSpace)
+    {
+        ProjectileMovementComponent->SetVelocityInLocalSpace(Velocity);
+    }
+    else
+    {
+        ProjectileMovementComponent->Velocity = Velocity;
+    }
+    ProjectileMovementComponent->UpdateComponentVelocity();
+
+    if (Particles->bAutoActivate)
+    {
+        Particles->Activate(true);
+    }
+    if (AudioComponent->bAutoActivate)
+    {
+        AudioComponent->Activate(true);
+    }
+
+    SetLifeSpan(InitialLifeSpan);
+
+    // Clients see a brand new actor
+    NetUpdateFrequency = Defaults->NetUpdateFrequency;
+    bReplicatedOnce = false;
+    SetReplicates(Defaults->GetIsReplicated() && !bReplicateAsEvents);
+    UUR_ReplicationGraph::NotifyNetUpdateFrequencyChanged(this);
+    ForceNetUpdate();
+
+    if (CanUseAnalyticFlight())
+    {
+        StartAnalyticFlight();
+    }
+
+    UUR_ProjectileBatchSubsystem* BatchSubsystem = GetWorld()->GetSubsystem<UUR_ProjectileBatchSubsystem>();
+    if (BatchSubsystem && BatchSubsystem->CanSimulate(this))
+    {
+        BatchSubsystem->AddProxy(this);
+    }
+}
+
+void AUR_Projectile::OnReleasedToPool()
+{
+    bInPool = true;
+    bBatchSimulated = false;
+    EventWeapon = nullptr;
+    GetWorldTimerManager().ClearTimer(AnalyticTimerHandle);
+
+    SetLifeSpan(0.f);
+    SetActorEnableCollision(false);
+    if (ProjectileMovementComponent->UpdatedComponent)
+    {
+        ProjectileMovementComponent->StopSimulating(FHitResult());
+    }
+    SetActorHiddenInGame(true);
+
+    Particles->Deactivate();
+    Particles->KillParticlesForced();
+    AudioComponent->Stop();
+
+    if (GetIsReplicated())
+    {
+        SetReplicates(false);
+
+        // SetReplicates(false) leaves open channels as they are.
+        // Close them now like a destroyed actor would, so clients destroy their copy right away.
+        UWorld* World = GetWorld();
+        if (UNetDriver* NetDriver = World->GetNetDriver())
+        {
+            NetDriver->NotifyActorDestroyed(this);
+        }
+        if (UDemoNetDriver* DemoNetDriver = World->GetDemoNetDriver())
+        {
+            DemoNetDriver->NotifyActorDestroyed(this);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Time at which a sphere moving from Origin with velocity Dir first touches a vertical capsule centered on zero.
+* Radius is the sum of the sphere and capsule radii, HalfSegment the capsule half height without hemispheres.
+*/
+static bool SphereCapsuleTimeOfImpact(const FVector& Origin, const FVector& Dir, float HalfSegment, float Radius, float MaxTime, float& OutTime)
+{
+    const float RadiusSq = FMath::Square(Radius);
+
+    // Already touching
+    const FVector ClosestOnAxis(0.f, 0.f, FMath::Clamp(Origin.Z, -HalfSegment, HalfSegment));
+    if (FVector::DistSquared(Origin, ClosestOnAxis) <= RadiusSq)
+    {
+        OutTime = 0.f;
+        return true;
+    }
+
+    bool bHit = false;
+    OutTime = MaxTime;
+
+    // Cylinder side
+    const float A = FMath::Square(Dir.X) + FMath::Square(Dir.Y);
+    if (A > KINDA_SMALL_NUMBER)
+    {
+        const float B = 2.f * (Origin.X * Dir.X + Origin.Y * Dir.Y);
+        const float C = FMath::Square(Origin.X) + FMath::Square(Origin.Y) - RadiusSq;
+        const float Disc = B * B - 4.f * A * C;
+        if (Disc >= 0.f)
+        {
+            const float Time = (-B - FMath::Sqrt(Disc)) / (2.f * A);
+            if (Time >= 0.f && Time <= OutTime && FMath::Abs(Origin.Z + Dir.Z * Time) <= HalfSegment)
+            {
+                OutTime = Time;
+                bHit = true;
+            }
+        }
+    }
+
+    // Hemispheres
+    const float SA = Dir.SizeSquared();
+    if (SA > KINDA_SMALL_NUMBER)
+    {
+        for (const float CapZ : { -HalfSegment, HalfSegment })
+        {
+            const FVector Rel = Origin - FVector(0.f, 0.f, CapZ);
+            const float SB = 2.f * (Rel | Dir);
+            const float SC = Rel.SizeSquared() - RadiusSq;
+            const float Disc = SB * SB - 4.f * SA * SC;
+            if (Disc >= 0.f)
+            {
+                const float Time = (-SB - FMath::Sqrt(Disc)) / (2.f * SA);
+                if (Time >= 0.f && Time <= OutTime)
+                {
+                    OutTime = Time;
+                    bHit = true;
+                }
+            }
+        }
+    }
+
+    return bHit;
+}
+
+bool AUR_Projectile::CanUseAnalyticFlight() const
+{
+    return bAnalyticFlight
+        && !ProjectileMovementComponent->bShouldBounce
+        && !ProjectileMovementComponent->bIsHomingProjectile
+        && ProjectileMovementComponent->ProjectileGravityScale == 0.f;
+}
+
+void AUR_Projectile::StartAnalyticFlight()
+{
+    // Movement component keeps moving us, but without sweeping
+    SetActorEnableCollision(false);
+    PlanAnalyticFlight();
+}
+
+void AUR_Projectile::AnalyticSweep(const FVector& Start, const FVector& End, TArray<FHitResult>& OutHits) const
+{
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(ProjectileAnalyticSweep), false, this);
+    if (bIgnoreInstigator && GetInstigator())
+    {
+        Params.AddIgnoredActor(GetInstigator());
+    }
+    GetWorld()->SweepMultiByChannel(OutHits, Start, End, FQuat::Identity, CollisionComponent->GetCollisionObjectType(), CollisionComponent->GetCollisionShape(), Params, FCollisionResponseParams(CollisionComponent->GetCollisionResponseToChannels()));
+}
+
+void AUR_Projectile::PlanAnalyticFlight()
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_AnalyticFlight);
+    INC_DWORD_STAT(STAT_OT_AnalyticFlightPlans);
+
+    const FVector Start = GetActorLocation();
+    const FVector Velocity = ProjectileMovementComponent->Velocity;
+    const float Window = FMath::Max(AnalyticLookAheadTime, 0.01f);
+    const float Radius = CollisionComponent->GetScaledSphereRadius();
+
+    float ImpactTime = Window;
+    bool bImpact = false;
+
+    // World geometry and other actors, one cast for the whole window. Pawns come from the snapshot below.
+    TArray<FHitResult> Hits;
+    AnalyticSweep(Start, Start + Velocity * Window, Hits);
+    for (const FHitResult& Hit : Hits)
+    {
+        AActor* HitActor = Hit.GetActor();
+        if (HitActor && HitActor->IsA<APawn>())
+        {
+            // A blocking pawn hides whatever is behind it, plan again from there
+            if (Hit.bBlockingHit)
+            {
+                ImpactTime = Hit.Time * Window;
+                break;
+            }
+            continue;
+        }
+        if (Hit.bBlockingHit || OverlapShouldExplodeOn(HitActor))
+        {
+            ImpactTime = Hit.Time * Window;
+            bImpact = true;
+            break;
+        }
+    }
+
+    // Moving targets, extrapolated with their current velocity
+    if (UUR_DamageableRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UUR_DamageableRegistrySubsystem>())
+    {
+        TArray<AActor*> Candidates;
+        const float HalfLength = 0.5f * Velocity.Size() * ImpactTime;
+        Registry->GatherCandidates(Start + 0.5f * Velocity * ImpactTime, HalfLength + Radius + AnalyticMaxTargetSpeed * ImpactTime, Candidates);
+
+        for (AActor* Candidate : Candidates)
+        {
+            const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(Candidate->GetRootComponent());
+            if (!Capsule || !OverlapShouldExplodeOn(Candidate))
+            {
+                continue;
+            }
+
+            float Time;
+            if (SphereCapsuleTimeOfImpact(Start - Capsule->GetComponentLocation(), Velocity - Candidate->GetVelocity(), Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere(), Capsule->GetScaledCapsuleRadius() + Radius, ImpactTime, Time))
+            {
+                ImpactTime = Time;
+                bImpact = true;
+            }
+        }
+    }
+
+    GetWorldTimerManager().SetTimer(AnalyticTimerHandle, this, bImpact ? &AUR_Projectile::ConfirmAnalyticImpact : &AUR_Projectile::PlanAnalyticFlight, FMath::Max(ImpactTime, KINDA_SMALL_NUMBER), false);
+}
+
+void AUR_Projectile::ConfirmAnalyticImpact()
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_AnalyticFlight);
+    INC_DWORD_STAT(STAT_OT_AnalyticFlightConfirms);
+
+    // We are within a frame of the impact, on either side
+    const FVector Location = GetActorLocation();
+    const FVector Step = ProjectileMovementComponent->Velocity * FMath::Max(GetWorld()->GetDeltaSeconds(), 0.01f);
+
+    TArray<FHitResult> Hits;
+    AnalyticSweep(Location - Step, Location + Step, Hits);
+    for (const FHitResult& Hit : Hits)
+    {
+        AActor* HitActor = Hit.GetActor();
+        if (HitActor && OverlapShouldExplodeOn(HitActor))
+        {
+            SetActorLocation(Hit.Location);
+            OnOverlap(CollisionComponent, HitActor, Hit.GetComponent(), Hit.Item, true, Hit);
+            return;
+        }
+        if (Hit.bBlockingHit)
+        {
+            SetActorLocation(Hit.Location);
+            OnHit(CollisionComponent, HitActor, Hit.GetComponent(), FVector::ZeroVector, Hit);
+            return;
+        }
+    }
+
+    // Target changed course, or something moved out of the way
+    PlanAnalyticFlight();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool AUR_Projectile::NeedsActorProxy(const UWorld* World) const
+{
+    // Visuals
+    if (World->GetNetMode() != NM_DedicatedServer)
+    {
+        return true;
+    }
+
+    // Replication
+    if (GetIsReplicated() && !bReplicateAsEvents)
+    {
+        return true;
+    }
+
+    // Blueprint hit logic, can only run on an instance
+    const UClass* Class = GetClass();
+    return Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AUR_Projectile, OnOverlap))
+        || Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AUR_Projectile, OverlapShouldExplodeOn));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AUR_Projectile::InitReplicatedProjectile()
+{
+    APawn* Shooter = GetInstigator();
+
+    // ShotId is only replicated to the shooter
+    if (ShotId != 0)
+    {
+        UUR_ProjectilePredictionSubsystem* Prediction = GetWorld()->GetSubsystem<UUR_ProjectilePredictionSubsystem>();
+        FUR_FakeProjectile Fake;
+        if (Prediction && Prediction->ConsumeFake(Shooter, ShotId, Fake))
+        {
+            if (AUR_Projectile* FakeProjectile = Fake.Projectile.Get())
+            {
+                // Catch up with the fake, which has been flying for a full round trip
+                FastForward(FMath::Min(GetWorld()->GetTimeSeconds() - Fake.SpawnTime, MaxFastForwardTime));
+                StartPredictionBlend(FakeProjectile->GetActorLocation());
+                FakeProjectile->Destroy();
+            }
+            else if (Fake.bExploded)
+            {
+                // Fake already exploded, don't show up a second time
+                SetActorHiddenInGame(true);
+                bImpactPredicted = true;
+                PredictedImpactLocation = Fake.ExplodeLocation;
+            }
+        }
+        return;
+    }
+
+    // Shots from other players reached the server half their ping after being fired
+    if (Shooter && !Shooter->IsLocallyControlled())
+    {
+        if (const APlayerState* PS = Shooter->GetPlayerState())
+        {
+            // Replicated Ping is compressed, in units of 4ms round trip
+            const float ShooterLatency = 0.5f * 0.004f * PS->Ping;
+            FastForward(FMath::Min(ShooterLatency, MaxFastForwardTime));
+        }
+    }
+}
+
+void AUR_Projectile::FastForward(float DeltaTime)
+{
+    if (DeltaTime > 0.f && ProjectileMovementComponent->UpdatedComponent)
+    {
+        // Movement component subdivides the step on its own, see MaxSimulationTimeStep
+        ProjectileMovementComponent->TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+    }
+}
+
+void AUR_Projectile::StartPredictionBlend(const FVector& FromLocation)
+{
+    if (IsActorBeingDestroyed() || PredictionBlendTime <= 0.f)
+    {
+        return;
+    }
+
+    PredictionOffset = FromLocation - GetActorLocation();
+    if (PredictionOffset.IsNearlyZero(1.f))
+    {
+        return;
+    }
 
-        UGameplayStatics::SpawnEmitterAtLocation(
-            GetWorld(),
-            ImpactTemplate,
-            FTransform(HitNormal.Rotation(), HitLocation, GetActorScale3D())
-        );
+    MeshBaseLocation = StaticMeshComponent->GetRelativeLocation();
+    ParticlesBaseLocation = Particles->GetRelativeLocation();
+    PredictionBlendRemaining = PredictionBlendTime;
+    ApplyVisualOffset(PredictionOffset);
+
+    if (UUR_ProjectilePredictionSubsystem* Prediction = GetWorld()->GetSubsystem<UUR_ProjectilePredictionSubsystem>())
+    {
+        Prediction->AddBlendingProjectile(this);
     }
 }
+
+bool AUR_Projectile::UpdatePredictionBlend(float DeltaTime)
+{
+    PredictionBlendRemaining = FMath::Max(PredictionBlendRemaining - DeltaTime, 0.f);
+    ApplyVisualOffset(PredictionOffset * (PredictionBlendRemaining / PredictionBlendTime));
+    return PredictionBlendRemaining > 0.f;
+}
+
+void AUR_Projectile::ApplyVisualOffset(const FVector& WorldOffset)
+{
+    // Visual components are attached to the collision, which rotates with velocity
+    const FVector LocalOffset = GetActorTransform().InverseTransformVectorNoScale(WorldOffset);
+    StaticMeshComponent->SetRelativeLocation(MeshBaseLocation + LocalOffset);
+    Particles->SetRelativeLocation(ParticlesBaseLocation + LocalOffset);
+}
@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Forward Declarations
 
+class AUR_Weapon;
 class UAudioComponent;
 class USphereComponent;
 class UStaticMeshComponent;
@@ -45,6 +46,12 @@ public:
 protected:
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void LifeSpanExpired() override;
+
+public:
+    virtual void PostInitProperties() override;
+    virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -78,6 +85,65 @@ public:
     UPROPERTY(EditAnywhere, Category = "Replication")
     bool bCutReplicationAfterSpawn;
 
+    /**
+    * Do not replicate the actor. Instead, the firing weapon multicasts one event per shot with spawn parameters,
+    * and one event per explosion. Clients simulate the flight locally. See FUR_ProjectileVolley.
+    * Only suitable for projectiles whose flight clients can reproduce (straight or ballistic, non-interactive).
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Replication")
+    bool bReplicateAsEvents;
+
+    /**
+    * Projectiles are relevant to viewers within this distance, extended by SplashRadius.
+    * The shooter always gets its own projectiles.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Replication")
+    float NetRelevancyDistance;
+
+    /**
+    * Update frequency once the projectile has been replicated, when its trajectory is predictable (no bounce, no homing).
+    * Clients simulate it from the initial replication, later updates only carry the explosion which forces a net update anyways.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Replication")
+    float PredictableNetUpdateFrequency;
+
+    /** Whether clients can simulate our whole flight from the initial replication */
+    bool HasPredictableTrajectory() const;
+
+    /**
+    * Number of projectiles of this class pre-spawned in the pool when a weapon firing them is spawned.
+    * Should be around the number of projectiles of this class flying at the same time in a busy match.
+    * See ot.ProjectilePoolDump for actual high water marks.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile|Pooling")
+    int32 PoolWarmUpCount;
+
+    /**
+    * Simulate movement in bulk with other projectiles, rather than with our own movement component.
+    * Much cheaper for spammable projectiles. See UUR_ProjectileBatchSubsystem.
+    * Ignored for bouncing and homing projectiles.
+    * Batched projectiles have no collision of their own, so they cannot be shot or overlapped by other actors.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile|Movement")
+    bool bBatchedSimulation;
+
+    /**
+    * Authority: resolve the flight analytically instead of sweeping every frame. Meant for very fast projectiles.
+    * The path for the next AnalyticLookAheadTime is cast once against world geometry and a snapshot of moving targets,
+    * and the impact is scheduled at its time of flight, where it is confirmed with a short sweep.
+    * Ignored for bouncing, homing and gravity-affected projectiles. Takes precedence over bBatchedSimulation.
+    * Analytic projectiles have no collision of their own, so they cannot be shot or overlapped by other actors.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile|Movement")
+    bool bAnalyticFlight;
+
+    /**
+    * Duration of the path cast at once in analytic flight.
+    * Longer is cheaper, but targets changing course are picked up later.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile|Movement", Meta = (EditCondition = "bAnalyticFlight"))
+    float AnalyticLookAheadTime;
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
@@ -136,7 +202,7 @@ public:
     void DealSplashDamage();
 
     /**
-    * Authority: replicate explosion & delayed destroy.
+    * Authority: replicate explosion & delayed destroy (or return to pool).
     * Client: play impact effects & destroy.
     */
     UFUNCTION(BlueprintCallable, Category = "Projectile")
@@ -151,6 +217,151 @@ public:
     void PlayImpactEffects(const FVector& HitLocation, const FVector& HitNormal);
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Pooling
+
+    /**
+    * Reset state of a pooled projectile so it flies again from given location, as if it was just spawned.
+    */
+    virtual void OnAcquiredFromPool(const FVector& Location, const FRotator& Rotation);
+
+    /**
+    * Freeze, hide and stop replicating a projectile going back to its pool.
+    */
+    virtual void OnReleasedToPool();
+
+    /** Whether this projectile is managed by the projectile pool, see UUR_ProjectilePoolSubsystem */
+    FORCEINLINE bool IsPooled() const { return bPooled; }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Batched simulation
+
+    /**
+    * Whether an actor is required for projectiles of this class, when simulated in batch.
+    * Without one, the projectile only exists in UUR_ProjectileBatchSubsystem.
+    * Actors are needed for visuals, replication, and Blueprint overrides of the hit logic.
+    * Called on class defaults.
+    */
+    virtual bool NeedsActorProxy(const UWorld* World) const;
+
+    /** Whether movement of this projectile is currently simulated by UUR_ProjectileBatchSubsystem */
+    FORCEINLINE bool IsBatchSimulated() const { return bBatchSimulated; }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Analytic flight
+
+    /**
+    * Whether this projectile class qualifies for analytic flight, see bAnalyticFlight.
+    */
+    bool CanUseAnalyticFlight() const;
+
+protected:
+
+    void StartAnalyticFlight();
+
+    /**
+    * Cast our path for the look ahead window, and schedule either the impact confirmation or the next plan.
+    */
+    void PlanAnalyticFlight();
+
+    /**
+    * Sweep around our current location to confirm the scheduled impact. Plans again if it does not happen.
+    */
+    void ConfirmAnalyticImpact();
+
+    void AnalyticSweep(const FVector& Start, const FVector& End, TArray<FHitResult>& OutHits) const;
+
+    FTimerHandle AnalyticTimerHandle;
+
+public:
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Client prediction
+
+    /**
+    * Predicted shot this projectile was fired from, see FSimulatedShotInfo::ShotId.
+    * Only replicated to the shooter, to match it with the fake projectile.
+    */
+    UPROPERTY(Replicated)
+    uint8 ShotId;
+
+    /**
+    * Client-side fake projectile, spawned by the shooting client before the server one replicates.
+    * Deals no damage.
+    */
+    bool bFakeProjectile;
+
+    /**
+    * Time for visuals of the server projectile to move from the fake projectile location to the actual one.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile|Prediction")
+    float PredictionBlendTime;
+
+    /**
+    * Maximum time a replicated projectile is simulated forward on clients, to make up for latency.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile|Prediction")
+    float MaxFastForwardTime;
+
+    /**
+    * Simulate movement forward by given time.
+    */
+    void FastForward(float DeltaTime);
+
+    /**
+    * Time to simulate forward in BeginPlay, for projectiles spawned late (eg. from replication events).
+    */
+    float SpawnFastForwardTime;
+
+    /** Authority: weapon replicating our explosion, when bReplicateAsEvents */
+    TWeakObjectPtr<AUR_Weapon> EventWeapon;
+
+    /** Authority: id of this projectile in the events of EventWeapon */
+    uint16 EventId;
+
+    /**
+    * Called every frame by UUR_ProjectilePredictionSubsystem while blending.
+    * Returns false once done.
+    */
+    bool UpdatePredictionBlend(float DeltaTime);
+
+protected:
+
+    friend class UUR_ProjectilePoolSubsystem;
+    friend class UUR_ProjectileBatchSubsystem;
+
+    bool bBatchSimulated;
+
+    /**
+    * Client: take over from our fake projectile, or catch up with the shooter's latency.
+    */
+    void InitReplicatedProjectile();
+
+    /**
+    * Offset visuals to given location, and blend them back to our actual location over PredictionBlendTime.
+    */
+    void StartPredictionBlend(const FVector& FromLocation);
+
+    void ApplyVisualOffset(const FVector& WorldOffset);
+
+    FVector PredictionOffset;
+    float PredictionBlendRemaining;
+    FVector MeshBaseLocation;
+    FVector ParticlesBaseLocation;
+
+    /** Fake projectile already played our impact effects here */
+    bool bImpactPredicted;
+    FVector PredictedImpactLocation;
+
+    /** Went through PreReplication once already */
+    bool bReplicatedOnce;
+
+    /** Spawned by the projectile pool, returns to it instead of being destroyed */
+    bool bPooled;
+
+    /** Currently waiting in the pool */
+    bool bInPool;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
 
 protected:
 
@@ -0,0 +1,389 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_ProjectileBatchSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+#include "OpenTournament.h"
+#include "UR_DamageableRegistrySubsystem.h"
+#include "UR_Projectile.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched Projectiles"), STAT_OT_BatchedProjectiles, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Projectile Batch"), STAT_OT_ProjectileBatch, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Projectile Batch Integrate"), STAT_OT_ProjectileBatchIntegrate, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Projectile Batch Sweeps"), STAT_OT_ProjectileBatchSweeps, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Projectile Batch Resolve"), STAT_OT_ProjectileBatchResolve, STATGROUP_OpenTournament);
+
+static TAutoConsoleVariable<int32> CVarProjectileBatching(
+    TEXT("ot.ProjectileBatching"),
+    1,
+    TEXT("Simulate projectiles flagged bBatchedSimulation in bulk.\n")
+    TEXT("0: every projectile uses its own movement component\n")
+    TEXT("1: batch (default)"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarProjectileBatchMinParallel(
+    TEXT("ot.ProjectileBatchMinParallel"),
+    8,
+    TEXT("Minimum number of batched projectiles before sweeps are dispatched to worker threads."),
+    ECVF_Default);
+
+static const FName ProjectileProfileName(TEXT("Projectile"));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ProjectileBatchSubsystem::Deinitialize()
+{
+    for (const TWeakObjectPtr<AUR_Projectile>& Proxy : Proxies)
+    {
+        if (Proxy.IsValid())
+        {
+            Proxy->bBatchSimulated = false;
+        }
+    }
+
+    Ids.Empty();
+    Positions.Empty();
+    Velocities.Empty();
+    PrevPositions.Empty();
+    Radii.Empty();
+    GravityZ.Empty();
+    MaxSpeeds.Empty();
+    LifeRemaining.Empty();
+    Damages.Empty();
+    FirstSweep.Empty();
+    IgnoreInstigator.Empty();
+    Proxies.Empty();
+    Owners.Empty();
+    Instigators.Empty();
+    Classes.Empty();
+    ScratchHits.Empty();
+
+    Super::Deinitialize();
+}
+
+bool UUR_ProjectileBatchSubsystem::CanSimulate(const AUR_Projectile* Projectile) const
+{
+    return CVarProjectileBatching.GetValueOnGameThread() != 0
+        && Projectile
+        && Projectile->bBatchedSimulation
+        && !Projectile->CanUseAnalyticFlight()
+        && !Projectile->ProjectileMovementComponent->bShouldBounce
+        && !Projectile->ProjectileMovementComponent->bIsHomingProjectile;
+}
+
+int32 UUR_ProjectileBatchSubsystem::AddProxy(AUR_Projectile* Projectile)
+{
+    UProjectileMovementComponent* Movement = Projectile->ProjectileMovementComponent;
+
+    const int32 Index = AddEntry(Projectile->GetClass(), Projectile->GetActorLocation(), Movement->Velocity, Projectile, Projectile->GetOwner(), Projectile->GetInstigator());
+    Radii[Index] = Projectile->CollisionComponent->GetScaledSphereRadius();
+    GravityZ[Index] = Movement->GetGravityZ();
+    MaxSpeeds[Index] = Movement->GetMaxSpeed();
+    Damages[Index] = Projectile->BaseDamage;
+    IgnoreInstigator[Index] = Projectile->bIgnoreInstigator;
+
+    // We move the proxy from now on. Its collision must not report overlaps on its own either.
+    Movement->SetComponentTickEnabled(false);
+    Projectile->SetActorEnableCollision(false);
+    Projectile->bBatchSimulated = true;
+
+    return Ids[Index];
+}
+
+void UUR_ProjectileBatchSubsystem::RemoveProxy(AUR_Projectile* Projectile)
+{
+    // Entry is dropped on next update
+    Projectile->bBatchSimulated = false;
+}
+
+int32 UUR_ProjectileBatchSubsystem::Launch(TSubclassOf<AUR_Projectile> InClass, const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator)
+{
+    const AUR_Projectile* Defaults = InClass->GetDefaultObject<AUR_Projectile>();
+    const UProjectileMovementComponent* Movement = Defaults->ProjectileMovementComponent;
+
+    // Same initial velocity as UProjectileMovementComponent::InitializeComponent
+    FVector Velocity = Movement->Velocity;
+    if (Movement->InitialSpeed > 0.f)
+    {
+        Velocity = Velocity.GetSafeNormal() * Movement->InitialSpeed;
+    }
+    if (Movement->bInitialVelocityInLocalSpace)
+    {
+        Velocity = Rotation.RotateVector(Velocity);
+    }
+
+    const int32 Index = AddEntry(InClass, Location, Velocity, nullptr, InOwner, InInstigator);
+    Radii[Index] = Defaults->CollisionComponent->GetScaledSphereRadius();
+    GravityZ[Index] = GetWorld()->GetGravityZ() * Movement->ProjectileGravityScale;
+    MaxSpeeds[Index] = Movement->GetMaxSpeed();
+    LifeRemaining[Index] = Defaults->InitialLifeSpan > 0.f ? Defaults->InitialLifeSpan : BIG_NUMBER;
+    Damages[Index] = Defaults->BaseDamage;
+    IgnoreInstigator[Index] = Defaults->bIgnoreInstigator;
+
+    return Ids[Index];
+}
+
+int32 UUR_ProjectileBatchSubsystem::AddEntry(UClass* InClass, const FVector& Location, const FVector& Velocity, AUR_Projectile* Proxy, AActor* InOwner, APawn* InInstigator)
+{
+    Ids.Add(++NextId);
+    Positions.Add(Location);
+    Velocities.Add(Velocity);
+    PrevPositions.Add(Location);
+    Radii.Add(0.f);
+    GravityZ.Add(0.f);
+    MaxSpeeds.Add(0.f);
+    LifeRemaining.Add(BIG_NUMBER);
+    Damages.Add(0.f);
+    FirstSweep.Add(true);
+    IgnoreInstigator.Add(true);
+    Proxies.Add(Proxy);
+    Owners.Add(InOwner);
+    Instigators.Add(InInstigator);
+    Classes.Add(InClass);
+
+    SET_DWORD_STAT(STAT_OT_BatchedProjectiles, Ids.Num());
+
+    return Ids.Num() - 1;
+}
+
+void UUR_ProjectileBatchSubsystem::RemoveEntry(int32 Index)
+{
+    Ids.RemoveAtSwap(Index, 1, false);
+    Positions.RemoveAtSwap(Index, 1, false);
+    Velocities.RemoveAtSwap(Index, 1, false);
+    PrevPositions.RemoveAtSwap(Index, 1, false);
+    Radii.RemoveAtSwap(Index, 1, false);
+    GravityZ.RemoveAtSwap(Index, 1, false);
+    MaxSpeeds.RemoveAtSwap(Index, 1, false);
+    LifeRemaining.RemoveAtSwap(Index, 1, false);
+    Damages.RemoveAtSwap(Index, 1, false);
+    FirstSweep.RemoveAtSwap(Index, 1, false);
+    IgnoreInstigator.RemoveAtSwap(Index, 1, false);
+    Proxies.RemoveAtSwap(Index, 1, false);
+    Owners.RemoveAtSwap(Index, 1, false);
+    Instigators.RemoveAtSwap(Index, 1, false);
+    Classes.RemoveAtSwap(Index, 1, false);
+
+    SET_DWORD_STAT(STAT_OT_BatchedProjectiles, Ids.Num());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ProjectileBatchSubsystem::Simulate(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_ProjectileBatch);
+
+    // Drop projectiles that ended since last update (exploded, destroyed, expired)
+    for (int32 i = Ids.Num() - 1; i >= 0; i--)
+    {
+        const bool bHasProxy = !Proxies[i].IsExplicitlyNull();
+        const AUR_Projectile* Proxy = Proxies[i].Get();
+        if (bHasProxy ? (!Proxy || !Proxy->bBatchSimulated) : LifeRemaining[i] <= 0.f)
+        {
+            RemoveEntry(i);
+        }
+    }
+
+    const int32 Num = Ids.Num();
+    if (Num == 0)
+    {
+        return;
+    }
+
+    {
+        SCOPE_CYCLE_COUNTER(STAT_OT_ProjectileBatchIntegrate);
+
+        // Same integration as UProjectileMovementComponent::ComputeMoveDelta, minus the features we don't support
+        for (int32 i = 0; i < Num; i++)
+        {
+            const FVector OldVelocity = Velocities[i];
+            FVector NewVelocity = OldVelocity;
+            NewVelocity.Z += GravityZ[i] * DeltaTime;
+            if (MaxSpeeds[i] > 0.f && NewVelocity.SizeSquared() > FMath::Square(MaxSpeeds[i]))
+            {
+                NewVelocity = NewVelocity.GetUnsafeNormal() * MaxSpeeds[i];
+            }
+
+            PrevPositions[i] = Positions[i];
+            Positions[i] += 0.5f * (OldVelocity + NewVelocity) * DeltaTime;
+            Velocities[i] = NewVelocity;
+            LifeRemaining[i] -= DeltaTime;
+        }
+    }
+
+    if (ScratchHits.Num() < Num)
+    {
+        ScratchHits.SetNum(Num);
+    }
+
+    {
+        SCOPE_CYCLE_COUNTER(STAT_OT_ProjectileBatchSweeps);
+
+        // Proxies have collision disabled while batched, so they never show up in the results
+        const UWorld* World = GetWorld();
+        const FCollisionQueryParams Params(SCENE_QUERY_STAT(ProjectileBatch), false);
+        ParallelFor(Num, [this, World, &Params](int32 i)
+        {
+            ScratchHits[i].Reset();
+            World->SweepMultiByProfile(ScratchHits[i], PrevPositions[i], Positions[i], FQuat::Identity, ProjectileProfileName, FCollisionShape::MakeSphere(Radii[i]), Params);
+        }, Num < CVarProjectileBatchMinParallel.GetValueOnGameThread());
+    }
+
+    {
+        SCOPE_CYCLE_COUNTER(STAT_OT_ProjectileBatchResolve);
+
+        // Hit handling calls into blueprint and modifies actors. Back to sequential.
+        // Going backwards, so detonated entries can be removed right away,
+        // while projectiles spawned by callbacks are appended and left for next update.
+        for (int32 i = Num - 1; i >= 0; i--)
+        {
+            if (ResolveHits(i, ScratchHits[i]))
+            {
+                RemoveEntry(i);
+                continue;
+            }
+
+            if (AUR_Projectile* Proxy = Proxies[i].Get())
+            {
+                if (Proxy->ProjectileMovementComponent->bRotationFollowsVelocity && !Velocities[i].IsNearlyZero())
+                {
+                    Proxy->SetActorLocationAndRotation(Positions[i], Velocities[i].Rotation());
+                }
+                else
+                {
+                    Proxy->SetActorLocation(Positions[i]);
+                }
+                Proxy->ProjectileMovementComponent->Velocity = Velocities[i];
+            }
+        }
+    }
+}
+
+bool UUR_ProjectileBatchSubsystem::ResolveHits(int32 Index, const TArray<FHitResult>& Hits)
+{
+    const bool bFirstSweep = FirstSweep[Index];
+    FirstSweep[Index] = false;
+
+    const bool bHasProxy = !Proxies[Index].IsExplicitlyNull();
+    AUR_Projectile* Proxy = Proxies[Index].Get();
+    if (bHasProxy && (!Proxy || !Proxy->bBatchSimulated))
+    {
+        return true;
+    }
+
+    // Results are sorted by distance, blocking hit last
+    for (const FHitResult& Hit : Hits)
+    {
+        AActor* HitActor = Hit.GetActor();
+
+        if (!Hit.bBlockingHit)
+        {
+            // Actors we were already overlapping have been reported by a previous sweep
+            if (Hit.bStartPenetrating && !bFirstSweep)
+            {
+                continue;
+            }
+
+            if (Proxy)
+            {
+                Proxy->SetActorLocation(Hit.Location);
+                Proxy->OnOverlap(Proxy->CollisionComponent, HitActor, Hit.GetComponent(), Hit.Item, true, Hit);
+                if (!Proxy->bBatchSimulated)
+                {
+                    return true;
+                }
+            }
+            else if (HitActor && HitActor->CanBeDamaged() && (!IgnoreInstigator[Index] || HitActor != Instigators[Index].Get()))
+            {
+                DetonateProxyless(Index, HitActor, Hit);
+                return true;
+            }
+        }
+        else
+        {
+            // Non-bouncing projectiles always explode on hit
+            if (Proxy)
+            {
+                Proxy->SetActorLocation(Hit.Location);
+                Proxy->OnHit(Proxy->CollisionComponent, HitActor, Hit.GetComponent(), FVector::ZeroVector, Hit);
+            }
+            else
+            {
+                DetonateProxyless(Index, HitActor, Hit);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void UUR_ProjectileBatchSubsystem::DetonateProxyless(int32 Index, AActor* HitActor, const FHitResult& Hit)
+{
+    const AUR_Projectile* Defaults = Classes[Index]->GetDefaultObject<AUR_Projectile>();
+
+    // No projectile actor to blame, the weapon is the damage causer.
+    // Like AUR_Projectile::DealSplashDamage, the instigator is not ignored and takes self splash.
+    AActor* DamageCauser = Owners[Index].Get();
+    APawn* InstigatorPawn = Instigators[Index].Get();
+    AController* InstigatorController = InstigatorPawn ? InstigatorPawn->GetController() : nullptr;
+
+    UUR_DamageableRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UUR_DamageableRegistrySubsystem>();
+    if (Defaults->SplashRadius > 0.f && Registry && Registry->IsBroadphaseEnabled())
+    {
+        Registry->ApplyRadialDamageWithFalloff(Damages[Index], Defaults->SplashMinimumDamage, Hit.Location, Defaults->InnerSplashRadius, Defaults->SplashRadius, Defaults->SplashFalloff,
+            Defaults->DamageTypeClass, TArray<AActor*>(), DamageCauser, InstigatorController, ECollisionChannel::ECC_Visibility);
+    }
+    else if (Defaults->SplashRadius > 0.f)
+    {
+        UGameplayStatics::ApplyRadialDamageWithFalloff(
+            GetWorld(),
+            Damages[Index],
+            Defaults->SplashMinimumDamage,
+            Hit.Location,
+            Defaults->InnerSplashRadius,
+            Defaults->SplashRadius,
+            Defaults->SplashFalloff,
+            Defaults->DamageTypeClass,
+            TArray<AActor*>(),
+            DamageCauser,
+            InstigatorController,
+            ECollisionChannel::ECC_Visibility
+        );
+    }
+    else if (HitActor)
+    {
+        UGameplayStatics::ApplyPointDamage(HitActor, Damages[Index], Velocities[Index].GetSafeNormal(), Hit, InstigatorController, DamageCauser, Defaults->DamageTypeClass);
+    }
+
+    OnProjectileDetonated.Broadcast(Ids[Index], Classes[Index], Hit.Location, Hit.ImpactNormal);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ProjectileBatchSubsystem::Tick(float DeltaTime)
+{
+    Simulate(DeltaTime);
+}
+
+ETickableTickType UUR_ProjectileBatchSubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_ProjectileBatchSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_ProjectileBatchSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_ProjectileBatchSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AActor;
+class APawn;
+class AUR_Projectile;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Called when a projectile without actor proxy detonates.
+* Params: projectile id, projectile class, location, normal.
+*/
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnBatchedProjectileDetonated, int32, UClass*, const FVector&, const FVector&);
+
+/**
+* Simulates simple projectiles (no bounce, no homing) in bulk, instead of one movement component per actor.
+*
+* Projectile state is kept in parallel arrays (structure of arrays) :
+* - Movement is integrated for all projectiles in one tight loop.
+* - Sweeps are dispatched as one parallel batch. They are read-only scene queries, actors are not touched.
+* - Hits are then processed on the game thread, in order.
+*
+* A projectile may or may not have an actor proxy :
+* - With a proxy (AUR_Projectile with bBatchedSimulation), the proxy's movement component is disabled.
+*   We move the proxy and forward hits to its OnOverlap/OnHit, so visuals, replication and Blueprint hooks keep working.
+* - Without proxy, the projectile only exists here. Damage is dealt using the class defaults.
+*   This is used when nothing would need the actor, see AUR_Projectile::NeedsActorProxy.
+*
+* Batching can be toggled at runtime with ot.ProjectileBatching. Only affects projectiles fired afterwards.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_ProjectileBatchSubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Whether projectile (or projectile class defaults) can be simulated here.
+    */
+    bool CanSimulate(const AUR_Projectile* Projectile) const;
+
+    /**
+    * Take over movement of a projectile actor.
+    * Returns projectile id.
+    */
+    int32 AddProxy(AUR_Projectile* Projectile);
+
+    /**
+    * Stop simulating a projectile actor. Its entry is dropped on next update.
+    */
+    void RemoveProxy(AUR_Projectile* Projectile);
+
+    /**
+    * Launch a projectile without actor proxy.
+    * InOwner is the damage causer, usually the firing weapon. Radial damage skips the causer, so it must not be the instigator pawn.
+    * Returns projectile id.
+    */
+    int32 Launch(TSubclassOf<AUR_Projectile> InClass, const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator);
+
+    /**
+    * Advance all projectiles by DeltaTime.
+    */
+    void Simulate(float DeltaTime);
+
+    FORCEINLINE int32 Num() const { return Ids.Num(); }
+
+    /**
+    * Whether projectile with given id is still flying.
+    */
+    FORCEINLINE bool IsSimulating(int32 Id) const { return Ids.Contains(Id); }
+
+    FOnBatchedProjectileDetonated OnProjectileDetonated;
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    int32 AddEntry(UClass* InClass, const FVector& Location, const FVector& Velocity, AUR_Projectile* Proxy, AActor* InOwner, APawn* InInstigator);
+
+    void RemoveEntry(int32 Index);
+
+    /**
+    * Process sweep results of a projectile. Returns true if the projectile detonated.
+    */
+    bool ResolveHits(int32 Index, const TArray<FHitResult>& Hits);
+
+    /**
+    * Hit handling for projectiles without proxy, mirroring AUR_Projectile::OnOverlap & OnHit.
+    */
+    void DetonateProxyless(int32 Index, AActor* HitActor, const FHitResult& Hit);
+
+    //============================================================
+    // Projectile state, one entry per projectile in each array
+    //============================================================
+
+    TArray<int32> Ids;
+
+    TArray<FVector> Positions;
+
+    TArray<FVector> Velocities;
+
+    /** Position before last integration, start of the sweep */
+    TArray<FVector> PrevPositions;
+
+    TArray<float> Radii;
+
+    TArray<float> GravityZ;
+
+    /** Speed limit, 0 = unlimited */
+    TArray<float> MaxSpeeds;
+
+    /** Remaining life time of proxyless projectiles. Proxies use actor lifespan */
+    TArray<float> LifeRemaining;
+
+    TArray<float> Damages;
+
+    /** Whether next sweep is the first one, initial overlaps are only reported then */
+    TArray<bool> FirstSweep;
+
+    TArray<bool> IgnoreInstigator;
+
+    TArray<TWeakObjectPtr<AUR_Projectile>> Proxies;
+
+    TArray<TWeakObjectPtr<AActor>> Owners;
+
+    TArray<TWeakObjectPtr<APawn>> Instigators;
+
+    /** Projectile classes, for damage parameters of proxyless projectiles */
+    UPROPERTY()
+    TArray<UClass*> Classes;
+
+    /** Sweep results, one array per projectile. Kept around to reuse allocations */
+    TArray<TArray<FHitResult>> ScratchHits;
+
+    int32 NextId;
+};
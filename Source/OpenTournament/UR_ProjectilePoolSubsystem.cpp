@@ -0,0 +1,221 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_ProjectilePoolSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+#include "OpenTournament.h"
+#include "UR_Projectile.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Active"), STAT_OT_ProjectilesActive, STATGROUP_OpenTournament);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Pooled"), STAT_OT_ProjectilesPooled, STATGROUP_OpenTournament);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles High Water Mark"), STAT_OT_ProjectilesHighWaterMark, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Spawned"), STAT_OT_ProjectilesSpawned, STATGROUP_OpenTournament);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Reused"), STAT_OT_ProjectilesReused, STATGROUP_OpenTournament);
+
+static TAutoConsoleVariable<int32> CVarProjectilePooling(
+    TEXT("ot.ProjectilePooling"),
+    1,
+    TEXT("Recycle authority projectiles instead of spawning and destroying them.\n")
+    TEXT("0: spawn a new projectile per shot\n")
+    TEXT("1: pool (default)"),
+    ECVF_Default);
+
+static FAutoConsoleCommandWithWorld ProjectilePoolDumpCommand(
+    TEXT("ot.ProjectilePoolDump"),
+    TEXT("Log usage of the projectile pools of the current world."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+    {
+        if (const UUR_ProjectilePoolSubsystem* PoolSubsystem = World ? World->GetSubsystem<UUR_ProjectilePoolSubsystem>() : nullptr)
+        {
+            PoolSubsystem->DumpPools();
+        }
+    }));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ProjectilePoolSubsystem::Deinitialize()
+{
+    Pools.Empty();
+    UpdateStats();
+
+    Super::Deinitialize();
+}
+
+bool UUR_ProjectilePoolSubsystem::IsPoolingEnabled() const
+{
+    return CVarProjectilePooling.GetValueOnGameThread() != 0 && GetWorld()->GetNetMode() != NM_Client;
+}
+
+AUR_Projectile* UUR_ProjectilePoolSubsystem::Acquire(TSubclassOf<AUR_Projectile> InClass, const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator)
+{
+    if (!InClass)
+    {
+        return nullptr;
+    }
+
+    if (!IsPoolingEnabled())
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.Owner = InOwner;
+        SpawnParams.Instigator = InInstigator;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        return GetWorld()->SpawnActor<AUR_Projectile>(InClass, Location, Rotation, SpawnParams);
+    }
+
+    FUR_ProjectilePool& Pool = Pools.FindOrAdd(InClass);
+
+    AUR_Projectile* Projectile = nullptr;
+    while (!Projectile && Pool.Free.Num() > 0)
+    {
+        // Pooled projectiles may have been destroyed from outside, eg. level streaming
+        Projectile = Pool.Free.Pop(false);
+        if (Projectile && Projectile->IsPendingKillPending())
+        {
+            Projectile = nullptr;
+        }
+    }
+
+    if (Projectile)
+    {
+        INC_DWORD_STAT(STAT_OT_ProjectilesReused);
+        Projectile->SetOwner(InOwner);
+        Projectile->SetInstigator(InInstigator);
+        Projectile->OnAcquiredFromPool(Location, Rotation);
+    }
+    else
+    {
+        Projectile = SpawnPooledProjectile(InClass, Location, Rotation, InOwner, InInstigator, false);
+        if (!Projectile)
+        {
+            return nullptr;
+        }
+        Pool.NumSpawned++;
+    }
+
+    Pool.NumActive++;
+    Pool.HighWaterMark = FMath::Max(Pool.HighWaterMark, Pool.NumActive);
+    UpdateStats();
+
+    return Projectile;
+}
+
+void UUR_ProjectilePoolSubsystem::Release(AUR_Projectile* Projectile)
+{
+    if (!Projectile || Projectile->bInPool || Projectile->IsPendingKillPending())
+    {
+        return;
+    }
+
+    FUR_ProjectilePool* Pool = Projectile->bPooled ? Pools.Find(Projectile->GetClass()) : nullptr;
+    if (!Pool)
+    {
+        Projectile->Destroy();
+        return;
+    }
+
+    Projectile->OnReleasedToPool();
+
+    Pool->NumActive--;
+    Pool->Free.Add(Projectile);
+    UpdateStats();
+}
+
+void UUR_ProjectilePoolSubsystem::NotifyProjectileDestroyed(AUR_Projectile* Projectile)
+{
+    if (FUR_ProjectilePool* Pool = Pools.Find(Projectile->GetClass()))
+    {
+        if (Projectile->bInPool)
+        {
+            Pool->Free.RemoveSingleSwap(Projectile, false);
+        }
+        else
+        {
+            Pool->NumActive--;
+        }
+        UpdateStats();
+    }
+}
+
+void UUR_ProjectilePoolSubsystem::WarmUp(TSubclassOf<AUR_Projectile> InClass)
+{
+    if (!InClass || !IsPoolingEnabled() || Pools.Contains(InClass))
+    {
+        return;
+    }
+
+    FUR_ProjectilePool& Pool = Pools.Add(InClass);
+
+    const int32 Count = InClass->GetDefaultObject<AUR_Projectile>()->PoolWarmUpCount;
+    Pool.Free.Reserve(Count);
+    for (int32 i = 0; i < Count; i++)
+    {
+        if (AUR_Projectile* Projectile = SpawnPooledProjectile(InClass, FVector::ZeroVector, FRotator::ZeroRotator, nullptr, nullptr, true))
+        {
+            Projectile->OnReleasedToPool();
+            Pool.Free.Add(Projectile);
+            Pool.NumSpawned++;
+        }
+    }
+
+    UpdateStats();
+}
+
+AUR_Projectile* UUR_ProjectilePoolSubsystem::SpawnPooledProjectile(TSubclassOf<AUR_Projectile> InClass, const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator, bool bWarmUp)
+{
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Owner = InOwner;
+    SpawnParams.Instigator = InInstigator;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    SpawnParams.bDeferConstruction = true;
+
+    AUR_Projectile* Projectile = GetWorld()->SpawnActor<AUR_Projectile>(InClass, Location, Rotation, SpawnParams);
+    if (Projectile)
+    {
+        INC_DWORD_STAT(STAT_OT_ProjectilesSpawned);
+        Projectile->bPooled = true;
+        if (bWarmUp)
+        {
+            // Warm-up projectiles go straight into the pool, they must not hit anything on spawn
+            Projectile->SetActorEnableCollision(false);
+        }
+        Projectile->FinishSpawning(FTransform(Rotation, Location));
+    }
+    return Projectile;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ProjectilePoolSubsystem::DumpPools() const
+{
+    GAME_LOG(LogWeapon, Log, "Projectile pools of %s (pooling %s):", *GetNameSafe(GetWorld()), IsPoolingEnabled() ? TEXT("enabled") : TEXT("disabled"));
+    for (const auto& Pair : Pools)
+    {
+        const FUR_ProjectilePool& Pool = Pair.Value;
+        GAME_LOG(LogWeapon, Log, "%s: Active=%i Free=%i HighWaterMark=%i Spawned=%i", *GetNameSafe(Pair.Key), Pool.NumActive, Pool.Free.Num(), Pool.HighWaterMark, Pool.NumSpawned);
+    }
+}
+
+void UUR_ProjectilePoolSubsystem::UpdateStats() const
+{
+#if STATS
+    int32 NumActive = 0;
+    int32 NumFree = 0;
+    int32 HighWaterMark = 0;
+    for (const auto& Pair : Pools)
+    {
+        NumActive += Pair.Value.NumActive;
+        NumFree += Pair.Value.Free.Num();
+        HighWaterMark += Pair.Value.HighWaterMark;
+    }
+    SET_DWORD_STAT(STAT_OT_ProjectilesActive, NumActive);
+    SET_DWORD_STAT(STAT_OT_ProjectilesPooled, NumFree);
+    SET_DWORD_STAT(STAT_OT_ProjectilesHighWaterMark, HighWaterMark);
+#endif
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_ProjectilePoolSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AActor;
+class APawn;
+class AUR_Projectile;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Pooled projectiles of a single class.
+*/
+USTRUCT()
+struct FUR_ProjectilePool
+{
+    GENERATED_BODY()
+
+    /** Projectiles waiting to be reused */
+    UPROPERTY()
+    TArray<AUR_Projectile*> Free;
+
+    /** Number of projectiles currently in flight (or exploding) */
+    int32 NumActive;
+
+    /** Highest NumActive reached, ie. the pool size this class actually needs */
+    int32 HighWaterMark;
+
+    /** Total number of projectiles spawned for this pool */
+    int32 NumSpawned;
+
+    FUR_ProjectilePool()
+        : NumActive(0)
+        , HighWaterMark(0)
+        , NumSpawned(0)
+    {}
+};
+
+/**
+* Per-class projectile pools, authority only.
+*
+* Spawning and destroying an actor per shot is costly (component registration, physics state, net channel),
+* so projectiles spawned by weapons are recycled instead.
+*
+* - Acquire() reuses a free projectile of the class if any, otherwise spawns one.
+* - Projectiles return themselves through Release() instead of being destroyed, see AUR_Projectile::LifeSpanExpired.
+* - WarmUp() pre-spawns AUR_Projectile::PoolWarmUpCount projectiles, so the first shots of a match don't hitch.
+*
+* Clients don't use pools. Their projectiles are created by replication, and destroyed when the server releases them.
+* Pooling can be toggled at runtime with ot.ProjectilePooling. Use ot.ProjectilePoolDump to list pool usage.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_ProjectilePoolSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Whether new projectiles should come from the pools.
+    */
+    bool IsPoolingEnabled() const;
+
+    /**
+    * Get a projectile ready to fly, from the pool of given class.
+    * Falls back to a regular spawn when pooling is disabled.
+    */
+    AUR_Projectile* Acquire(TSubclassOf<AUR_Projectile> InClass, const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator);
+
+    /**
+    * Return a projectile to its pool.
+    * The projectile is hidden, frozen and removed from replication until acquired again.
+    */
+    void Release(AUR_Projectile* Projectile);
+
+    /**
+    * Make sure the pool of given class holds at least its warm-up count of projectiles.
+    * Only does something the first time a class is warmed up.
+    */
+    void WarmUp(TSubclassOf<AUR_Projectile> InClass);
+
+    /**
+    * Forget a pooled projectile that is being destroyed.
+    */
+    void NotifyProjectileDestroyed(AUR_Projectile* Projectile);
+
+    /**
+    * Log usage of all pools.
+    */
+    void DumpPools() const;
+
+protected:
+
+    AUR_Projectile* SpawnPooledProjectile(TSubclassOf<AUR_Projectile> InClass, const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator, bool bWarmUp);
+
+    void UpdateStats() const;
+
+    UPROPERTY()
+    TMap<UClass*, FUR_ProjectilePool> Pools;
+};
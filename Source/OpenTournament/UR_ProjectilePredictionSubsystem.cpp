@@ -0,0 +1,140 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_ProjectilePredictionSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+#include "UR_Projectile.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+static TAutoConsoleVariable<float> CVarProjectilePredictionTimeout(
+    TEXT("ot.ProjectilePredictionTimeout"),
+    1.f,
+    TEXT("Seconds after which a predicted projectile is removed, if the server projectile did not show up."),
+    ECVF_Default);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ProjectilePredictionSubsystem::Deinitialize()
+{
+    Fakes.Empty();
+    BlendingProjectiles.Empty();
+
+    Super::Deinitialize();
+}
+
+float UUR_ProjectilePredictionSubsystem::GetFakeTimeout() const
+{
+    return CVarProjectilePredictionTimeout.GetValueOnGameThread();
+}
+
+void UUR_ProjectilePredictionSubsystem::AddFake(AUR_Projectile* Fake)
+{
+    PruneFakes();
+
+    FUR_FakeProjectile& Entry = Fakes.AddDefaulted_GetRef();
+    Entry.Projectile = Fake;
+    Entry.Shooter = Fake->GetInstigator();
+    Entry.ShotId = Fake->ShotId;
+    Entry.SpawnTime = GetWorld()->GetTimeSeconds();
+    Entry.bExploded = false;
+    Entry.ExplodeLocation = FVector::ZeroVector;
+}
+
+void UUR_ProjectilePredictionSubsystem::NotifyFakeExploded(AUR_Projectile* Fake)
+{
+    for (FUR_FakeProjectile& Entry : Fakes)
+    {
+        if (Entry.Projectile == Fake)
+        {
+            Entry.bExploded = true;
+            Entry.ExplodeLocation = Fake->GetActorLocation();
+            return;
+        }
+    }
+}
+
+void UUR_ProjectilePredictionSubsystem::RejectShot(APawn* Shooter, uint8 ShotId)
+{
+    FUR_FakeProjectile Fake;
+    if (ConsumeFake(Shooter, ShotId, Fake) && Fake.Projectile.IsValid())
+    {
+        Fake.Projectile->Destroy();
+    }
+}
+
+bool UUR_ProjectilePredictionSubsystem::ConsumeFake(const APawn* Shooter, uint8 ShotId, FUR_FakeProjectile& OutFake)
+{
+    PruneFakes();
+
+    for (int32 i = 0; i < Fakes.Num(); i++)
+    {
+        if (Fakes[i].ShotId == ShotId && Fakes[i].Shooter == Shooter)
+        {
+            OutFake = Fakes[i];
+            Fakes.RemoveAt(i, 1, false);
+            return true;
+        }
+    }
+    return false;
+}
+
+void UUR_ProjectilePredictionSubsystem::PruneFakes()
+{
+    const float ExpireTime = GetWorld()->GetTimeSeconds() - GetFakeTimeout();
+
+    // Oldest first
+    int32 NumExpired = 0;
+    while (NumExpired < Fakes.Num() && Fakes[NumExpired].SpawnTime < ExpireTime)
+    {
+        if (AUR_Projectile* Fake = Fakes[NumExpired].Projectile.Get())
+        {
+            Fake->Destroy();
+        }
+        NumExpired++;
+    }
+
+    if (NumExpired > 0)
+    {
+        Fakes.RemoveAt(0, NumExpired, false);
+    }
+}
+
+void UUR_ProjectilePredictionSubsystem::AddBlendingProjectile(AUR_Projectile* Projectile)
+{
+    BlendingProjectiles.AddUnique(Projectile);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ProjectilePredictionSubsystem::Tick(float DeltaTime)
+{
+    for (int32 i = BlendingProjectiles.Num() - 1; i >= 0; i--)
+    {
+        AUR_Projectile* Projectile = BlendingProjectiles[i].Get();
+        if (!Projectile || !Projectile->UpdatePredictionBlend(DeltaTime))
+        {
+            BlendingProjectiles.RemoveAtSwap(i, 1, false);
+        }
+    }
+
+    if (Fakes.Num() > 0)
+    {
+        PruneFakes();
+    }
+}
+
+ETickableTickType UUR_ProjectilePredictionSubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_ProjectilePredictionSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_ProjectilePredictionSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_ProjectilePredictionSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class APawn;
+class AUR_Projectile;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* A client-side fake projectile, waiting for its server counterpart.
+*/
+struct FUR_FakeProjectile
+{
+    TWeakObjectPtr<AUR_Projectile> Projectile;
+
+    TWeakObjectPtr<APawn> Shooter;
+
+    uint8 ShotId;
+
+    /** Local time the fake was spawned */
+    float SpawnTime;
+
+    /** Whether the fake already exploded. Entry is kept so the server projectile doesn't explode twice */
+    bool bExploded;
+
+    FVector ExplodeLocation;
+};
+
+/**
+* Keeps track of client-predicted projectiles on the shooting client.
+*
+* Fake projectiles are spawned in AUR_Weapon::SimulateShot when the fire mode has bPredictProjectile.
+* Each is tagged with the ShotId sent along with the shot (FSimulatedShotInfo).
+* When the server projectile replicates with the same ShotId, it takes over from the fake, see AUR_Projectile::BeginPlay.
+*
+* Fakes are killed when the server discards the shot (UUR_FireModeBasic::ClientRejectShot),
+* or when no server projectile showed up within ot.ProjectilePredictionTimeout.
+*
+* Also drives the visual blend of server projectiles which took over from a fake, so projectiles don't need to tick.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_ProjectilePredictionSubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Time after which an unmatched fake projectile is removed.
+    */
+    float GetFakeTimeout() const;
+
+    /**
+    * Register a freshly spawned fake projectile.
+    */
+    void AddFake(AUR_Projectile* Fake);
+
+    /**
+    * Fake projectile exploded on its own.
+    */
+    void NotifyFakeExploded(AUR_Projectile* Fake);
+
+    /**
+    * Server discarded the shot, remove the fake without any effect.
+    */
+    void RejectShot(APawn* Shooter, uint8 ShotId);
+
+    /**
+    * Find and forget the fake projectile matching a server projectile.
+    * Returns false if there is none (timed out, or not predicted).
+    */
+    bool ConsumeFake(const APawn* Shooter, uint8 ShotId, FUR_FakeProjectile& OutFake);
+
+    /**
+    * Update visual blend of given projectile every frame until done.
+    * See AUR_Projectile::UpdatePredictionBlend.
+    */
+    void AddBlendingProjectile(AUR_Projectile* Projectile);
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    /**
+    * Forget about fakes older than the timeout, and destroy those still flying.
+    */
+    void PruneFakes();
+
+    TArray<FUR_FakeProjectile> Fakes;
+
+    TArray<TWeakObjectPtr<AUR_Projectile>> BlendingProjectiles;
+};
@@ -0,0 +1,358 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_ReplicationGraph.h"
+
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "ReplicationGraphTypes.h"
+#include "UObject/UObjectIterator.h"
+
+#include "OpenTournament.h"
+#include "UR_JumpPad.h"
+#include "UR_Pickup.h"
+#include "UR_PickupBase.h"
+#include "UR_Projectile.h"
+#include "UR_Teleporter.h"
+#include "UR_Weapon.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+static TAutoConsoleVariable<float> CVarRepGraphCellSize(
+    TEXT("ot.RepGraph.CellSize"),
+    10000.f,
+    TEXT("Size of the replication graph spatial grid cells, in units. Read when the net driver starts."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRepGraphSpatialBias(
+    TEXT("ot.RepGraph.SpatialBias"),
+    -150000.f,
+    TEXT("Origin of the replication graph spatial grid, on both X and Y. Should be below the lowest coordinate of the maps."),
+    ECVF_Default);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ReplicationGraph::InitGlobalActorClassSettings()
+{
+    Super::InitGlobalActorClassSettings();
+
+    ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), EUR_ClassRepNodeMapping::NotRouted);
+    ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EUR_ClassRepNodeMapping::NotRouted);
+    ClassRepNodePolicies.Set(AUR_Weapon::StaticClass(), EUR_ClassRepNodeMapping::NotRouted);
+
+    ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EUR_ClassRepNodeMapping::RelevantAllConnections);
+    ClassRepNodePolicies.Set(APlayerState::StaticClass(), EUR_ClassRepNodeMapping::RelevantAllConnections);
+
+    ClassRepNodePolicies.Set(APawn::StaticClass(), EUR_ClassRepNodeMapping::Spatialize_Dynamic);
+    ClassRepNodePolicies.Set(AUR_Projectile::StaticClass(), EUR_ClassRepNodeMapping::Spatialize_Dynamic);
+
+    ClassRepNodePolicies.Set(AUR_PickupBase::StaticClass(), EUR_ClassRepNodeMapping::Spatialize_Dormancy);
+    ClassRepNodePolicies.Set(AUR_Pickup::StaticClass(), EUR_ClassRepNodeMapping::Spatialize_Dormancy);
+    ClassRepNodePolicies.Set(AUR_JumpPad::StaticClass(), EUR_ClassRepNodeMapping::Spatialize_Dormancy);
+    ClassRepNodePolicies.Set(AUR_Teleporter::StaticClass(), EUR_ClassRepNodeMapping::Spatialize_Dormancy);
+
+    // The graph is frame based, convert class defaults to replication periods and cull distances
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        UClass* Class = *It;
+        const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+        if (!ActorCDO || !ActorCDO->GetIsReplicated())
+        {
+            continue;
+        }
+
+        if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+        {
+            continue;
+        }
+
+        FClassReplicationInfo ClassInfo;
+        ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrame(ActorCDO->NetUpdateFrequency);
+
+        if (ActorCDO->bAlwaysRelevant || ActorCDO->bOnlyRelevantToOwner)
+        {
+            ClassInfo.SetCullDistanceSquared(0.f);
+        }
+        else if (const AUR_Projectile* ProjectileCDO = Cast<AUR_Projectile>(ActorCDO))
+        {
+            // Same range as AUR_Projectile::PostInitProperties. Blueprint CDOs load their defaults after it, so compute it again
+            ClassInfo.SetCullDistanceSquared(FMath::Square(ProjectileCDO->NetRelevancyDistance + ProjectileCDO->SplashRadius));
+        }
+        else
+        {
+            ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+        }
+
+        GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+    }
+}
+
+void UUR_ReplicationGraph::InitGlobalGraphNodes()
+{
+    Super::InitGlobalGraphNodes();
+
+    const float SpatialBias = CVarRepGraphSpatialBias.GetValueOnGameThread();
+
+    GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+    GridNode->CellSize = CVarRepGraphCellSize.GetValueOnGameThread();
+    GridNode->SpatialBias = FVector2D(SpatialBias, SpatialBias);
+    AddGlobalGraphNode(GridNode);
+
+    AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+    AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UUR_ReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+    Super::InitConnectionGraphNodes(RepGraphConnection);
+
+    UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+    AddConnectionGraphNode(Node, RepGraphConnection);
+
+    AlwaysRelevantForConnectionList.Emplace(RepGraphConnection->NetConnection, Node);
+}
+
+void UUR_ReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+    AlwaysRelevantForConnectionList.RemoveAllSwap([NetConnection](const FUR_ConnectionAlwaysRelevantNode& Item)
+    {
+        return Item.NetConnection == NetConnection;
+    });
+
+    Super::RemoveClientConnection(NetConnection);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32 UUR_ReplicationGraph::GetReplicationPeriodFrame(float NetUpdateFrequency) const
+{
+    return FMath::Max<uint32>((uint32)FMath::RoundToFloat(NetDriver->NetServerMaxTickRate / FMath::Max(NetUpdateFrequency, 1.f)), 1);
+}
+
+void UUR_ReplicationGraph::NotifyNetUpdateFrequencyChanged(AActor* Actor)
+{
+    UNetDriver* ActorNetDriver = Actor ? Actor->GetNetDriver() : nullptr;
+    UUR_ReplicationGraph* Graph = ActorNetDriver ? ActorNetDriver->GetReplicationDriver<UUR_ReplicationGraph>() : nullptr;
+    if (Graph)
+    {
+        if (FGlobalActorReplicationInfo* GlobalInfo = Graph->GlobalActorReplicationInfoMap.Find(Actor))
+        {
+            GlobalInfo->Settings.ReplicationPeriodFrame = Graph->GetReplicationPeriodFrame(Actor->NetUpdateFrequency);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+EUR_ClassRepNodeMapping UUR_ReplicationGraph::GetMappingPolicy(const AActor* Actor) const
+{
+    if (const EUR_ClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Actor->GetClass()))
+    {
+        return *Policy;
+    }
+
+    if (Actor->bAlwaysRelevant)
+    {
+        return EUR_ClassRepNodeMapping::RelevantAllConnections;
+    }
+
+    return Actor->IsRootComponentStatic() ? EUR_ClassRepNodeMapping::Spatialize_Static : EUR_ClassRepNodeMapping::Spatialize_Dynamic;
+}
+
+UReplicationGraphNode_AlwaysRelevant_ForConnection* UUR_ReplicationGraph::GetAlwaysRelevantNodeForConnection(UNetConnection* Connection) const
+{
+    if (Connection)
+    {
+        if (const FUR_ConnectionAlwaysRelevantNode* Pair = AlwaysRelevantForConnectionList.FindByKey(Connection))
+        {
+            return Pair->Node;
+        }
+    }
+    return nullptr;
+}
+
+void UUR_ReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+    AActor* Actor = ActorInfo.Actor;
+    if (Actor->bOnlyRelevantToOwner)
+    {
+        // Connection is not known yet when spawning, see ServerReplicateActors
+        ActorsWithoutNetConnection.Add(Actor);
+        return;
+    }
+
+    switch (GetMappingPolicy(Actor))
+    {
+    case EUR_ClassRepNodeMapping::NotRouted:
+        if (AUR_Weapon* Weapon = Cast<AUR_Weapon>(Actor))
+        {
+            // Weapons spawned with an owner become dependent actors in NotifyWeaponOwnerChanged
+            if (!Weapon->GetOwner())
+            {
+                AddSpatializedWeapon(Weapon, GlobalInfo);
+            }
+        }
+        break;
+
+    case EUR_ClassRepNodeMapping::RelevantAllConnections:
+        AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+        break;
+
+    case EUR_ClassRepNodeMapping::Spatialize_Static:
+        GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+        break;
+
+    case EUR_ClassRepNodeMapping::Spatialize_Dynamic:
+        GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+        break;
+
+    case EUR_ClassRepNodeMapping::Spatialize_Dormancy:
+        GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void UUR_ReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+    AActor* Actor = ActorInfo.Actor;
+    if (Actor->bOnlyRelevantToOwner)
+    {
+        if (ActorsWithoutNetConnection.Remove(Actor) == 0)
+        {
+            if (UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNodeForConnection(Actor->GetNetConnection()))
+            {
+                Node->NotifyRemoveNetworkActor(ActorInfo);
+            }
+        }
+        return;
+    }
+
+    switch (GetMappingPolicy(Actor))
+    {
+    case EUR_ClassRepNodeMapping::NotRouted:
+        if (AUR_Weapon* Weapon = Cast<AUR_Weapon>(Actor))
+        {
+            if (SpatializedWeapons.Contains(Weapon))
+            {
+                RemoveSpatializedWeapon(Weapon);
+            }
+            else
+            {
+                // Destroyed while held, eg. stacked into an existing weapon or inventory cleared
+                RemoveDependentActor(Weapon->GetOwner(), Weapon);
+            }
+        }
+        break;
+
+    case EUR_ClassRepNodeMapping::RelevantAllConnections:
+        AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+        break;
+
+    case EUR_ClassRepNodeMapping::Spatialize_Static:
+        GridNode->RemoveActor_Static(ActorInfo);
+        break;
+
+    case EUR_ClassRepNodeMapping::Spatialize_Dynamic:
+        GridNode->RemoveActor_Dynamic(ActorInfo);
+        break;
+
+    case EUR_ClassRepNodeMapping::Spatialize_Dormancy:
+        GridNode->RemoveActor_Dormancy(ActorInfo);
+        break;
+
+    default:
+        break;
+    }
+}
+
+int32 UUR_ReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+    for (int32 i = ActorsWithoutNetConnection.Num() - 1; i >= 0; i--)
+    {
+        AActor* Actor = ActorsWithoutNetConnection[i];
+        if (UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNodeForConnection(Actor->GetNetConnection()))
+        {
+            ActorsWithoutNetConnection.RemoveAtSwap(i, 1, false);
+            Node->NotifyAddNetworkActor(FNewReplicatedActorInfo(Actor));
+        }
+    }
+
+    return Super::ServerReplicateActors(DeltaSeconds);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ReplicationGraph::AddDependentActor(AActor* Parent, AActor* Child)
+{
+    if (Parent && Child)
+    {
+        FGlobalActorReplicationInfo& ParentInfo = GlobalActorReplicationInfoMap.Get(Parent);
+        ParentInfo.DependentActorList.PrepareForWrite();
+        ParentInfo.DependentActorList.ConditionalAdd(Child);
+    }
+}
+
+void UUR_ReplicationGraph::RemoveDependentActor(AActor* Parent, AActor* Child)
+{
+    if (Parent && Child)
+    {
+        if (FGlobalActorReplicationInfo* ParentInfo = GlobalActorReplicationInfoMap.Find(Parent))
+        {
+            ParentInfo->DependentActorList.PrepareForWrite();
+            ParentInfo->DependentActorList.RemoveFast(Child);
+        }
+    }
+}
+
+void UUR_ReplicationGraph::AddSpatializedWeapon(AUR_Weapon* Weapon, FGlobalActorReplicationInfo& GlobalInfo)
+{
+    if (!SpatializedWeapons.Contains(Weapon))
+    {
+        SpatializedWeapons.Add(Weapon);
+        GridNode->AddActor_Dynamic(FNewReplicatedActorInfo(Weapon), GlobalInfo);
+    }
+}
+
+void UUR_ReplicationGraph::RemoveSpatializedWeapon(AUR_Weapon* Weapon)
+{
+    if (SpatializedWeapons.RemoveSwap(Weapon) > 0)
+    {
+        GridNode->RemoveActor_Dynamic(FNewReplicatedActorInfo(Weapon));
+    }
+}
+
+void UUR_ReplicationGraph::NotifyWeaponOwnerChanged(AUR_Weapon* Weapon, AActor* OldOwner, AActor* NewOwner)
+{
+    UNetDriver* WeaponNetDriver = Weapon ? Weapon->GetNetDriver() : nullptr;
+    UUR_ReplicationGraph* Graph = WeaponNetDriver ? WeaponNetDriver->GetReplicationDriver<UUR_ReplicationGraph>() : nullptr;
+    if (!Graph)
+    {
+        return;
+    }
+
+    if (OldOwner != NewOwner)
+    {
+        // Inactive weapons are dormant, so they cost nothing to the character's viewers until brought up
+        Graph->RemoveDependentActor(OldOwner, Weapon);
+        Graph->AddDependentActor(NewOwner, Weapon);
+    }
+
+    if (NewOwner)
+    {
+        Graph->RemoveSpatializedWeapon(Weapon);
+    }
+    else if (FGlobalActorReplicationInfo* GlobalInfo = Graph->GlobalActorReplicationInfoMap.Find(Weapon))
+    {
+        // Only once added to the graph, otherwise RouteAddNetworkActorToNodes takes care of it
+        Graph->AddSpatializedWeapon(Weapon, *GlobalInfo);
+    }
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "UR_ReplicationGraph.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AActor;
+class AUR_Weapon;
+class UNetConnection;
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+class UReplicationGraphNode_GridSpatialization2D;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Which node replicated actors of a class are routed to.
+*/
+enum class EUR_ClassRepNodeMapping : uint8
+{
+    /** Not routed to any node, replicated through another actor (eg. held weapons, dependent on their character) */
+    NotRouted,
+
+    /** Replicated to every connection, regardless of distance */
+    RelevantAllConnections,
+
+    /** Placed actors that never move */
+    Spatialize_Static,
+
+    /** Moving actors, their grid cells are updated every frame */
+    Spatialize_Dynamic,
+
+    /** Placed actors that are dormant most of the time. Treated as static while dormant, dynamic while awake */
+    Spatialize_Dormancy,
+};
+
+/**
+* Connection and its always relevant node.
+*/
+USTRUCT()
+struct FUR_ConnectionAlwaysRelevantNode
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UNetConnection* NetConnection;
+
+    UPROPERTY()
+    UReplicationGraphNode_AlwaysRelevant_ForConnection* Node;
+
+    FUR_ConnectionAlwaysRelevantNode()
+        : NetConnection(nullptr)
+        , Node(nullptr)
+    {}
+
+    FUR_ConnectionAlwaysRelevantNode(UNetConnection* InConnection, UReplicationGraphNode_AlwaysRelevant_ForConnection* InNode)
+        : NetConnection(InConnection)
+        , Node(InNode)
+    {}
+
+    bool operator==(const UNetConnection* InConnection) const { return NetConnection == InConnection; }
+};
+
+/**
+* Replication graph of OpenTournament, enabled through ReplicationDriverClassName in DefaultEngine.ini.
+*
+* The default net driver checks every replicated actor against every connection, each frame.
+* Here actors are routed once to a node, and each connection only gathers the nodes around its viewer :
+*
+* - Pawns and projectiles go in a 2D spatial grid, so a connection only considers the ones in nearby cells.
+* - Pickups, jump pads and teleporters go in the same grid as dormant static actors.
+* - GameState, PlayerStates and other bAlwaysRelevant actors go in a single list shared by all connections.
+* - Owner only actors (PlayerController) go in the always relevant node of their connection.
+* - Weapons are dependent actors of the character holding them, see NotifyWeaponOwnerChanged.
+*   Weapons without owner (placed in the level, parked) go in the grid as dynamic actors until picked up.
+*   The inventory component itself replicates with the character, its weapon list being owner only.
+*
+* Actor::IsNetRelevantFor and GetNetPriority are not called by the graph.
+* Cull distances and replication periods come from the class defaults instead, see InitGlobalActorClassSettings.
+* Priority is scaled by distance to the viewer by the graph itself.
+* Actors changing their NetUpdateFrequency at runtime must call NotifyNetUpdateFrequencyChanged.
+*/
+UCLASS(Transient)
+class OPENTOURNAMENT_API UUR_ReplicationGraph : public UReplicationGraph
+{
+    GENERATED_BODY()
+
+public:
+
+    //~ Begin UReplicationGraph Interface
+    virtual void InitGlobalActorClassSettings() override;
+    virtual void InitGlobalGraphNodes() override;
+    virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+    virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+    virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+    virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+    virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+    //~ End UReplicationGraph Interface
+
+    /**
+    * Move a weapon to the dependent actors of its new owner, or to the grid when it has none.
+    * Called by the weapon on authority whenever it is given or parked. No-op when the graph is not in use.
+    */
+    static void NotifyWeaponOwnerChanged(AUR_Weapon* Weapon, AActor* OldOwner, AActor* NewOwner);
+
+    /**
+    * Apply the current NetUpdateFrequency of an actor to its replication period.
+    * No-op when the graph is not in use, or the actor is not replicated yet.
+    */
+    static void NotifyNetUpdateFrequencyChanged(AActor* Actor);
+
+protected:
+
+    /** Replication period in frames, for the given update frequency */
+    uint32 GetReplicationPeriodFrame(float NetUpdateFrequency) const;
+
+    EUR_ClassRepNodeMapping GetMappingPolicy(const AActor* Actor) const;
+
+    UReplicationGraphNode_AlwaysRelevant_ForConnection* GetAlwaysRelevantNodeForConnection(UNetConnection* Connection) const;
+
+    void AddDependentActor(AActor* Parent, AActor* Child);
+
+    void RemoveDependentActor(AActor* Parent, AActor* Child);
+
+    /** Explicit routing of our classes, and their children. Other classes are routed from their replication flags */
+    TClassMap<EUR_ClassRepNodeMapping> ClassRepNodePolicies;
+
+    UPROPERTY()
+    UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+    UPROPERTY()
+    UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+    UPROPERTY()
+    TArray<FUR_ConnectionAlwaysRelevantNode> AlwaysRelevantForConnectionList;
+
+    /** Owner only actors that have no connection yet, routed to their connection node as soon as they do */
+    UPROPERTY()
+    TArray<AActor*> ActorsWithoutNetConnection;
+
+    /** Weapons without owner, routed to the grid instead of being dependent actors */
+    UPROPERTY()
+    TArray<AUR_Weapon*> SpatializedWeapons;
+
+    void AddSpatializedWeapon(AUR_Weapon* Weapon, FGlobalActorReplicationInfo& GlobalInfo);
+
+    void RemoveSpatializedWeapon(AUR_Weapon* Weapon);
+};
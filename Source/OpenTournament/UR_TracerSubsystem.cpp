@@ -0,0 +1,211 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_TracerSubsystem.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/LineBatchComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInterface.h"
+
+#include "OpenTournament.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracers Added"), STAT_OT_TracersAdded, STATGROUP_OpenTournament);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tracers Live"), STAT_OT_TracersLive, STATGROUP_OpenTournament);
+DECLARE_CYCLE_STAT(TEXT("Tracers Update"), STAT_OT_TracersUpdate, STATGROUP_OpenTournament);
+
+static TAutoConsoleVariable<int32> CVarTracerRenderer(
+    TEXT("ot.TracerRenderer"),
+    1,
+    TEXT("How hitscan tracers of fire modes using the shared tracer renderer are drawn.\n")
+    TEXT("0: spawn the fire mode BeamTemplate per shot\n")
+    TEXT("1: instanced tracer meshes (default)\n")
+    TEXT("2: world line batcher"),
+    ECVF_Scalability);
+
+/** Number of per-instance custom data floats : color RGB and opacity */
+static const int32 TracerCustomDataFloats = 4;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_TracerSubsystem::Deinitialize()
+{
+    if (IsValid(RendererActor))
+    {
+        RendererActor->Destroy();
+    }
+    RendererActor = nullptr;
+    Batches.Empty();
+    ScratchTransforms.Empty();
+
+    Super::Deinitialize();
+}
+
+bool UUR_TracerSubsystem::IsEnabled() const
+{
+    return CVarTracerRenderer.GetValueOnGameThread() != 0 && GetWorld() && GetWorld()->GetNetMode() != NM_DedicatedServer;
+}
+
+void UUR_TracerSubsystem::AddTracer(UStaticMesh* Mesh, UMaterialInterface* Material, const FVector& Start, const FVector& End, const FLinearColor& Color, float Width, float LifeTime)
+{
+    INC_DWORD_STAT(STAT_OT_TracersAdded);
+
+    FUR_TracerBatch* Batch = (Mesh && CVarTracerRenderer.GetValueOnGameThread() == 1) ? FindOrCreateBatch(Mesh, Material) : nullptr;
+    if (!Batch)
+    {
+        if (ULineBatchComponent* LineBatcher = GetWorld()->LineBatcher)
+        {
+            LineBatcher->DrawLine(Start, End, Color, SDPG_World, Width, LifeTime);
+        }
+        return;
+    }
+
+    Batch->Starts.Add(Start);
+    Batch->Ends.Add(End);
+    Batch->Colors.Add(Color);
+    Batch->Widths.Add(Width);
+    Batch->Ages.Add(0.f);
+    Batch->LifeTimes.Add(FMath::Max(LifeTime, KINDA_SMALL_NUMBER));
+}
+
+FUR_TracerBatch* UUR_TracerSubsystem::FindOrCreateBatch(UStaticMesh* Mesh, UMaterialInterface* Material)
+{
+    for (FUR_TracerBatch& Batch : Batches)
+    {
+        if (Batch.Mesh == Mesh && Batch.Material == Material)
+        {
+            return IsValid(Batch.Component) ? &Batch : nullptr;
+        }
+    }
+
+    if (!IsValid(RendererActor))
+    {
+        FActorSpawnParameters Params;
+        Params.ObjectFlags |= RF_Transient;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        RendererActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, Params);
+        if (!RendererActor)
+        {
+            return nullptr;
+        }
+    }
+
+    UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(RendererActor);
+    Component->SetMobility(EComponentMobility::Movable);
+    Component->SetStaticMesh(Mesh);
+    if (Material)
+    {
+        Component->SetMaterial(0, Material);
+    }
+    Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    Component->SetCanEverAffectNavigation(false);
+    Component->SetCastShadow(false);
+    Component->SetNumCustomDataFloats(TracerCustomDataFloats);
+    if (!RendererActor->GetRootComponent())
+    {
+        RendererActor->SetRootComponent(Component);
+    }
+    Component->RegisterComponent();
+
+    FUR_TracerBatch& Batch = Batches.AddDefaulted_GetRef();
+    Batch.Component = Component;
+    Batch.Mesh = Mesh;
+    Batch.Material = Material;
+
+    const FVector MeshSize = Mesh->GetBoundingBox().GetSize();
+    Batch.MeshLength = FMath::Max(MeshSize.X, 1.f);
+    Batch.MeshThickness = FMath::Max(FMath::Max(MeshSize.Y, MeshSize.Z), 1.f);
+
+    return &Batch;
+}
+
+void UUR_TracerSubsystem::UpdateBatch(FUR_TracerBatch& Batch, float DeltaTime)
+{
+    // Tracers are drawn at least once, even if shorter than a frame
+    for (int32 i = Batch.Num() - 1; i >= 0; i--)
+    {
+        if (Batch.Ages[i] >= Batch.LifeTimes[i])
+        {
+            Batch.Starts.RemoveAtSwap(i, 1, false);
+            Batch.Ends.RemoveAtSwap(i, 1, false);
+            Batch.Colors.RemoveAtSwap(i, 1, false);
+            Batch.Widths.RemoveAtSwap(i, 1, false);
+            Batch.Ages.RemoveAtSwap(i, 1, false);
+            Batch.LifeTimes.RemoveAtSwap(i, 1, false);
+        }
+    }
+
+    UInstancedStaticMeshComponent* Component = Batch.Component;
+    const int32 Num = Batch.Num();
+    if (!IsValid(Component) || (Num == 0 && Batch.NumVisibleInstances == 0))
+    {
+        return;
+    }
+
+    // Instances are only ever added, unused ones are collapsed
+    const FTransform Collapsed(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+    while (Component->GetInstanceCount() < Num)
+    {
+        Component->AddInstance(Collapsed);
+    }
+
+    ScratchTransforms.Reset();
+    for (int32 i = 0; i < Num; i++)
+    {
+        const FVector Dir = Batch.Ends[i] - Batch.Starts[i];
+        const float Length = Dir.Size();
+        const float Thickness = Batch.Widths[i] / Batch.MeshThickness;
+        ScratchTransforms.Emplace(
+            FRotationMatrix::MakeFromX(Dir).ToQuat(),
+            0.5f * (Batch.Starts[i] + Batch.Ends[i]),
+            FVector(Length / Batch.MeshLength, Thickness, Thickness)
+        );
+
+        const FLinearColor& Color = Batch.Colors[i];
+        Component->SetCustomDataValue(i, 0, Color.R, false);
+        Component->SetCustomDataValue(i, 1, Color.G, false);
+        Component->SetCustomDataValue(i, 2, Color.B, false);
+        Component->SetCustomDataValue(i, 3, 1.f - Batch.Ages[i] / Batch.LifeTimes[i], false);
+
+        Batch.Ages[i] += DeltaTime;
+    }
+    for (int32 i = Num; i < Batch.NumVisibleInstances; i++)
+    {
+        ScratchTransforms.Add(Collapsed);
+    }
+
+    Component->BatchUpdateInstancesTransforms(0, ScratchTransforms, true, true, true);
+    Batch.NumVisibleInstances = Num;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_TracerSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_OT_TracersUpdate);
+
+    int32 NumLive = 0;
+    for (FUR_TracerBatch& Batch : Batches)
+    {
+        UpdateBatch(Batch, DeltaTime);
+        NumLive += Batch.Num();
+    }
+
+    SET_DWORD_STAT(STAT_OT_TracersLive, NumLive);
+}
+
+ETickableTickType UUR_TracerSubsystem::GetTickableTickType() const
+{
+    return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UUR_TracerSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_TracerSubsystem, STATGROUP_Tickables);
+}
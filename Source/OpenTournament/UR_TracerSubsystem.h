@@ -0,0 +1,126 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UR_TracerSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class AActor;
+class UInstancedStaticMeshComponent;
+class UMaterialInterface;
+class UStaticMesh;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Live tracers sharing the same mesh and material, drawn by one instanced component.
+*/
+USTRUCT()
+struct FUR_TracerBatch
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UInstancedStaticMeshComponent* Component;
+
+    UPROPERTY()
+    UStaticMesh* Mesh;
+
+    UPROPERTY()
+    UMaterialInterface* Material;
+
+    /** Mesh size along X, tracers are scaled relative to it */
+    float MeshLength;
+
+    /** Mesh size along Y and Z */
+    float MeshThickness;
+
+    TArray<FVector> Starts;
+    TArray<FVector> Ends;
+    TArray<FLinearColor> Colors;
+    TArray<float> Widths;
+    TArray<float> Ages;
+    TArray<float> LifeTimes;
+
+    /** Number of instances showing a tracer, the rest are collapsed */
+    int32 NumVisibleInstances;
+
+    FUR_TracerBatch()
+        : Component(nullptr)
+        , Mesh(nullptr)
+        , Material(nullptr)
+        , MeshLength(1.f)
+        , MeshThickness(1.f)
+        , NumVisibleInstances(0)
+    {}
+
+    FORCEINLINE int32 Num() const { return Starts.Num(); }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Per-world tracer renderer for hitscan beams.
+*
+* Adding a tracer is a few array appends. All tracers of a batch are written to a single instanced static mesh component
+* once per frame : one transform per tracer, plus color and fading opacity as per-instance custom data.
+* Instances are recycled, collapsed when unused, and never removed.
+*
+* Tracers are simulated on the CPU. Without a tracer mesh, or with ot.TracerRenderer 2,
+* they are drawn with the world line batcher instead, which needs neither instancing nor a material.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_TracerSubsystem : public UWorldSubsystem
+    , public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void Deinitialize() override;
+
+    /**
+    * Whether fire modes flagged bUseTracerRenderer should go through here.
+    */
+    bool IsEnabled() const;
+
+    /**
+    * Draw a tracer from Start to End, fading out over LifeTime.
+    */
+    void AddTracer(UStaticMesh* Mesh, UMaterialInterface* Material, const FVector& Start, const FVector& End, const FLinearColor& Color, float Width, float LifeTime);
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual TStatId GetStatId() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+    //~ End FTickableGameObject Interface
+
+protected:
+
+    FUR_TracerBatch* FindOrCreateBatch(UStaticMesh* Mesh, UMaterialInterface* Material);
+
+    /**
+    * Drop expired tracers, write the others to the instanced component, and age them.
+    */
+    void UpdateBatch(FUR_TracerBatch& Batch, float DeltaTime);
+
+    /** Owner of the instanced components */
+    UPROPERTY()
+    AActor* RendererActor;
+
+    /** One batch per mesh and material pair, there are only a handful */
+    UPROPERTY()
+    TArray<FUR_TracerBatch> Batches;
+
+    /** Transforms written to a batch. Kept around to reuse allocations */
+    TArray<FTransform> ScratchTransforms;
+};
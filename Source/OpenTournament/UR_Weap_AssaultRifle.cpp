@@ -12,14 +12,12 @@ AUR_Weap_AssaultRifle::AUR_Weap_AssaultRifle(const FObjectInitializer& ObjectIni
     /*ConstructorHelpers::FObjectFinder<USkeletalMesh> newAsset(TEXT("SkeletalMesh'/Game/SciFiWeapDark/Weapons/Darkness_AssaultRifle.Darkness_AssaultRifle'"));
     USkeletalMesh* helper = newAsset.Object;
     Mesh1P->SetSkeletalMesh(helper);*/
-    WeaponName = "Assault Rifle";
+    SetDefaultWeaponData(GetMutableDefault<UUR_AssaultRifleData>());
 
     /*ConstructorHelpers::FObjectFinder<USoundCue> newAssetSound(TEXT("SoundCue'/Game/SciFiWeapDark/Sound/Rifle/Rifle_Lower_Cue.Rifle_Lower_Cue'"));
     USoundCue* helperSound;
     helperSound = newAssetSound.Object;
     Sound->SetSound(helperSound);*/
-
-    AmmoName = "Assault";
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -12,6 +12,23 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+* Default configuration of the assault rifle, used when no other WeaponData is assigned.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_AssaultRifleData : public UUR_WeaponData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_AssaultRifleData()
+    {
+        WeaponName = "Assault Rifle";
+        WeaponGroup = 0;
+        AmmoName = "Assault";
+    }
+};
+
 /**
  *
  */
@@ -12,6 +12,23 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+* Default configuration of the grenade launcher, used when no other WeaponData is assigned.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_GrenadeLauncherData : public UUR_WeaponData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_GrenadeLauncherData()
+    {
+        WeaponName = "Grenade Launcher";
+        WeaponGroup = 3;
+        AmmoName = "Grenade";
+    }
+};
+
 /**
  *
  */
@@ -12,12 +12,10 @@ AUR_Weap_Pistol::AUR_Weap_Pistol(const FObjectInitializer& ObjectInitializer)
     /*ConstructorHelpers::FObjectFinder<USkeletalMesh> newAsset(TEXT("SkeletalMesh'/Game/SciFiWeapDark/Weapons/Darkness_Pistol.Darkness_Pistol'"));
     USkeletalMesh* helper = newAsset.Object;
     Mesh1P->SetSkeletalMesh(helper);*/
-    WeaponName = "Pistol";
+    SetDefaultWeaponData(GetMutableDefault<UUR_PistolData>());
 
     /*ConstructorHelpers::FObjectFinder<USoundCue> newAssetSound(TEXT("SoundCue'/Game/SciFiWeapDark/Sound/Pistol/Pistol_Lower_Cue.Pistol_Lower_Cue'"));
     USoundCue* helperSound;
     helperSound = newAssetSound.Object;
     Sound->SetSound(helperSound);*/
-
-    AmmoName = "Pistol";
 }
\ No newline at end of file
@@ -11,6 +11,23 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+* Default configuration of the pistol, used when no other WeaponData is assigned.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_PistolData : public UUR_WeaponData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_PistolData()
+    {
+        WeaponName = "Pistol";
+        WeaponGroup = 5;
+        AmmoName = "Pistol";
+    }
+};
+
 /**
 *
 */
@@ -12,14 +12,19 @@
 AUR_Weap_RocketLauncher::AUR_Weap_RocketLauncher(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
 {
-    WeaponName = "Rocket Launcher";
-    AmmoName = "Rocket";
+    SetDefaultWeaponData(GetMutableDefault<UUR_RocketLauncherData>());
 
     ChargedFireMode = CreateDefaultSubobject<UUR_FireModeCharged>(TEXT("ChargedFireMode"));
     ChargedFireMode->Index = 1;
-    ChargedFireMode->MaxChargeLevel = 3;
-    ChargedFireMode->ChargeInterval = 0.9f;     //BP
-    ChargedFireMode->MaxChargeHoldTime = 0.5f;   //BP
+
+    UUR_RocketLauncherChargedData* ChargedData = GetMutableDefault<UUR_RocketLauncherChargedData>();
+    ChargedFireMode->FireModeData = ChargedData;
+#if WITH_EDITORONLY_DATA
+    // Former inline defaults, migrated along with the overrides of blueprints saved before FireModeData
+    ChargedFireMode->MaxChargeLevel_DEPRECATED = ChargedData->MaxChargeLevel;
+    ChargedFireMode->ChargeInterval_DEPRECATED = ChargedData->ChargeInterval;
+    ChargedFireMode->MaxChargeHoldTime_DEPRECATED = ChargedData->MaxChargeHoldTime;
+#endif
 
     RocketsOffset = 5.f;
     DoubleSpread = 1.2f;
@@ -29,16 +34,16 @@ AUR_Weap_RocketLauncher::AUR_Weap_RocketLauncher(const FObjectInitializer& Objec
 
 void AUR_Weap_RocketLauncher::AuthorityShot_Implementation(UUR_FireModeBasic* FireMode, const FSimulatedShotInfo& SimulatedInfo)
 {
-    if (FireMode == ChargedFireMode && FireMode->ProjectileClass)
+    if (FireMode == ChargedFireMode && FireMode->GetProjectileClass())
     {
         FVector FireLoc;
         FRotator FireRot;
-        GetValidatedFireVector(SimulatedInfo, FireLoc, FireRot, FireMode->MuzzleSocketName);
+        GetValidatedFireVector(SimulatedInfo, FireLoc, FireRot, FireMode->GetMuzzleSocketName());
 
         // Centered rocket
         if (ChargedFireMode->ChargeLevel != 2)
         {
-            SpawnProjectile(FireMode->ProjectileClass, FireLoc, FireRot);
+            SpawnProjectile(FireMode->GetProjectileClass(), FireLoc, FireRot);
         }
 
         // Spread rockets
@@ -51,7 +56,7 @@ void AUR_Weap_RocketLauncher::AuthorityShot_Implementation(UUR_FireModeBasic* Fi
                 FVector RelOffset(0.f, DirY * RocketsOffset, 0.f);
                 FVector NewLoc = FireLoc + FireRot.RotateVector(RelOffset);
                 FRotator NewRot = FMath::Lerp(FireRot, (NewLoc - SpreadReferencePoint).Rotation(), Spread);
-                Super::SpawnProjectile(FireMode->ProjectileClass, NewLoc, NewRot);
+                Super::SpawnProjectile(FireMode->GetProjectileClass(), NewLoc, NewRot);
             }
         }
     }
@@ -11,6 +11,40 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+* Default configuration of the rocket launcher, used when no other WeaponData is assigned.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_RocketLauncherData : public UUR_WeaponData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_RocketLauncherData()
+    {
+        WeaponName = "Rocket Launcher";
+        WeaponGroup = 2;
+        AmmoName = "Rocket";
+    }
+};
+
+/**
+* Default configuration of the rocket launcher charged fire mode, loading up to 3 rockets.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_RocketLauncherChargedData : public UUR_FireModeChargedData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_RocketLauncherChargedData()
+    {
+        MaxChargeLevel = 3;
+        ChargeInterval = 0.9f;
+        MaxChargeHoldTime = 0.5f;
+    }
+};
+
 /**
  *
  */
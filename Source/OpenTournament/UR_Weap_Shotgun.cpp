@@ -4,7 +4,16 @@
 
 #include "UR_Weap_Shotgun.h"
 
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+
+#include "UR_Character.h"
+#include "UR_CosmeticEventSubsystem.h"
+#include "UR_FireModeBasic.h"
+#include "UR_HitscanBatchSubsystem.h"
+#include "UR_LagCompensationComponent.h"
 #include "UR_Projectile.h"
+#include "UR_TracerSubsystem.h"
 #include "UR_FunctionLibrary.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -12,41 +21,53 @@
 AUR_Weap_Shotgun::AUR_Weap_Shotgun(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
 {
-    WeaponName = "Shotgun";
-    AmmoName = "Shotgun";
-
-    SpawnBoxes = {
-        { FVector(5.0f, 0.0f, 0.0f), FVector(5.f, 15.f, 15.f), 2 },
-        { FVector(5.0f, -15.0f, -15.0f), FVector(5.f, 15.f, 15.f), 2 },
-        { FVector(5.0f, -15.0f, +15.0f), FVector(5.f, 15.f, 15.f), 2 },
-        { FVector(5.0f, +15.0f, -15.0f), FVector(5.f, 15.f, 15.f), 2 },
-        { FVector(5.0f, +15.0f, +15.0f), FVector(5.f, 15.f, 15.f), 2 },
-    };
-    OffsetSpread = 0.2f;
-    UseMuzzleDistance = 100.f;
+    UUR_ShotgunData* Defaults = GetMutableDefault<UUR_ShotgunData>();
+    SetDefaultWeaponData(Defaults);
+#if WITH_EDITORONLY_DATA
+    SpawnBoxes_DEPRECATED = Defaults->SpawnBoxes;
+    OffsetSpread_DEPRECATED = Defaults->OffsetSpread;
+    UseMuzzleDistance_DEPRECATED = Defaults->UseMuzzleDistance;
+    HitscanPelletCount_DEPRECATED = Defaults->HitscanPelletCount;
+    HitscanPelletSpread_DEPRECATED = Defaults->HitscanPelletSpread;
+#endif
 
     ShotgunFireMode = CreateDefaultSubobject<UUR_FireModeBasic>(TEXT("ShotgunFireMode"));
 }
 
+#if WITH_EDITORONLY_DATA
+void AUR_Weap_Shotgun::CopyDeprecatedContent(UUR_WeaponData* Data) const
+{
+    Super::CopyDeprecatedContent(Data);
+
+    UUR_ShotgunData* ShotgunData = CastChecked<UUR_ShotgunData>(Data);
+    ShotgunData->SpawnBoxes = SpawnBoxes_DEPRECATED;
+    ShotgunData->OffsetSpread = OffsetSpread_DEPRECATED;
+    ShotgunData->UseMuzzleDistance = UseMuzzleDistance_DEPRECATED;
+    ShotgunData->HitscanPelletCount = HitscanPelletCount_DEPRECATED;
+    ShotgunData->HitscanPelletSpread = HitscanPelletSpread_DEPRECATED;
+}
+#endif
+
 void AUR_Weap_Shotgun::AuthorityShot_Implementation(UUR_FireModeBasic* FireMode, const FSimulatedShotInfo& SimulatedInfo)
 {
-    if (FireMode == ShotgunFireMode && FireMode->ProjectileClass)
+    if (FireMode == ShotgunFireMode && FireMode->GetProjectileClass())
     {
         FVector FireLoc;
         FRotator FireRot;
-        GetValidatedFireVector(SimulatedInfo, FireLoc, FireRot, FireMode->MuzzleSocketName);
+        GetValidatedFireVector(SimulatedInfo, FireLoc, FireRot, FireMode->GetMuzzleSocketName());
 
-        FVector SpreadReferencePoint = FireLoc - UseMuzzleDistance * FireRot.Vector();
+        const UUR_ShotgunData* Data = GetShotgunData();
+        FVector SpreadReferencePoint = FireLoc - Data->UseMuzzleDistance * FireRot.Vector();
 
-        for (const FShotgunSpawnBox& SpawnBox : SpawnBoxes)
+        for (const FShotgunSpawnBox& SpawnBox : Data->SpawnBoxes)
         {
             for (int32 j = 0; j < SpawnBox.Count; j++)
             {
                 FVector RelOffset(SpawnBox.RelativeLoc);
                 RelOffset += UUR_FunctionLibrary::RandomVectorInRange(-SpawnBox.Extent, SpawnBox.Extent);
                 FVector SpawnLoc = FireLoc + FireRot.RotateVector(RelOffset);
-                FRotator SpawnRot = FMath::Lerp(FireRot, (SpawnLoc - SpreadReferencePoint).Rotation(), OffsetSpread);
-                SpawnProjectile(FireMode->ProjectileClass, SpawnLoc, SpawnRot);
+                FRotator SpawnRot = FMath::Lerp(FireRot, (SpawnLoc - SpreadReferencePoint).Rotation(), Data->OffsetSpread);
+                SpawnProjectile(FireMode->GetProjectileClass(), SpawnLoc, SpawnRot);
             }
         }
     }
@@ -55,3 +76,173 @@ void AUR_Weap_Shotgun::AuthorityShot_Implementation(UUR_FireModeBasic* FireMode,
         Super::AuthorityShot_Implementation(FireMode, SimulatedInfo);
     }
 }
+
+void AUR_Weap_Shotgun::GetPelletTraceEnds(UUR_FireModeBasic* FireMode, const FVector& TraceStart, const FVector& AimDir, int32 Seed, TArray<FVector>& OutTraceEnds) const
+{
+    const UUR_ShotgunData* Data = GetShotgunData();
+    const int32 Count = FMath::Max(Data->HitscanPelletCount, 0);
+    OutTraceEnds.SetNumUninitialized(Count);
+    SeededRandCones(AimDir, Data->HitscanPelletSpread, Seed, Count, OutTraceEnds.GetData());
+    for (FVector& TraceEnd : OutTraceEnds)
+    {
+        TraceEnd = TraceStart + FireMode->GetHitscanTraceDistance() * TraceEnd;
+    }
+}
+
+void AUR_Weap_Shotgun::SimulateHitscanShot_Implementation(UUR_FireModeBasic* FireMode, FSimulatedShotInfo& OutSimulatedInfo, FHitscanVisualInfo& OutHitscanInfo)
+{
+    if (FireMode != ShotgunFireMode)
+    {
+        Super::SimulateHitscanShot_Implementation(FireMode, OutSimulatedInfo, OutHitscanInfo);
+        return;
+    }
+
+    FVector FireLoc;
+    FRotator FireRot;
+    GetFireVector(FireLoc, FireRot);
+
+    OutSimulatedInfo.Vectors.EmplaceAt(0, FireLoc);
+    OutSimulatedInfo.Vectors.EmplaceAt(1, FireRot.Vector());
+    OutSimulatedInfo.Seed = FMath::Max(FMath::Rand(), 1);
+
+    // Pellets are traced in PlayHitscanEffects, no need to do it twice
+    OutHitscanInfo.Vectors.EmplaceAt(0, FireLoc);
+    OutHitscanInfo.Vectors.EmplaceAt(1, FireRot.Vector());
+    OutHitscanInfo.Seed = OutSimulatedInfo.Seed;
+}
+
+void AUR_Weap_Shotgun::AuthorityHitscanShot_Implementation(UUR_FireModeBasic* FireMode, const FSimulatedShotInfo& SimulatedInfo, FHitscanVisualInfo& OutHitscanInfo)
+{
+    if (FireMode != ShotgunFireMode)
+    {
+        Super::AuthorityHitscanShot_Implementation(FireMode, SimulatedInfo, OutHitscanInfo);
+        return;
+    }
+
+    FVector TraceStart;
+    FRotator FireRot;
+    GetValidatedFireVector(SimulatedInfo, TraceStart, FireRot);
+
+    ConsumeAmmo(FireMode->GetInitialAmmoCost());
+
+    GetPelletTraceEnds(FireMode, TraceStart, FireRot.Vector(), SimulatedInfo.Seed, PelletTraceEnds);
+    const int32 NumPellets = PelletTraceEnds.Num();
+
+    FCollisionQueryParams Params;
+    GetHitscanQueryParams(Params);
+
+    {
+        // Trace all pellets against hitboxes as the shooter was seeing them
+        FUR_ScopedLagCompensation LagCompensation(URCharOwner, SimulatedInfo.ClientTime);
+
+        if (UUR_HitscanBatchSubsystem* HitscanBatch = GetWorld()->GetSubsystem<UUR_HitscanBatchSubsystem>())
+        {
+            HitscanBatch->SweepImmediate(TraceStart, PelletTraceEnds, Params, PelletHits);
+        }
+        else
+        {
+            PelletHits.SetNum(FMath::Max(PelletHits.Num(), NumPellets));
+            for (int32 i = 0; i < NumPellets; i++)
+            {
+                PelletHits[i].Reset();
+                HitscanSweep(GetWorld(), TraceStart, PelletTraceEnds[i], Params, PelletHits[i]);
+            }
+        }
+    }
+
+    // Merge damage per victim, so a full blast results in one damage event
+    struct FPelletVictim
+    {
+        AActor* Actor;
+        float Damage;
+        FHitResult Hit;
+    };
+    TArray<FPelletVictim, TInlineAllocator<8>> Victims;
+
+    for (int32 i = 0; i < NumPellets; i++)
+    {
+        FHitResult Hit;
+        HitscanPickHit(PelletHits[i], TraceStart, PelletTraceEnds[i], Hit);
+        PelletHits[i].Reset();
+
+        AActor* HitActor = Hit.bBlockingHit ? Hit.GetActor() : nullptr;
+        if (!HitActor)
+        {
+            continue;
+        }
+
+        FPelletVictim* Victim = Victims.FindByPredicate([HitActor](const FPelletVictim& V) { return V.Actor == HitActor; });
+        if (Victim)
+        {
+            Victim->Damage += FireMode->GetHitscanDamage();
+        }
+        else
+        {
+            Victims.Add({ HitActor, FireMode->GetHitscanDamage(), Hit });
+        }
+    }
+
+    for (const FPelletVictim& Victim : Victims)
+    {
+        // Victim might have been destroyed by a previous damage event (eg. exploding projectile)
+        if (!IsValid(Victim.Actor))
+        {
+            continue;
+        }
+        const FVector ShotDir = (Victim.Hit.TraceEnd - Victim.Hit.TraceStart).GetSafeNormal();
+        UGameplayStatics::ApplyPointDamage(Victim.Actor, Victim.Damage, ShotDir, Victim.Hit, GetInstigatorController(), this, FireMode->GetHitscanDamageType());
+    }
+
+    // Only replicate origin, aim and seed. Clients regenerate pellets themselves
+    OutHitscanInfo.Vectors.EmplaceAt(0, TraceStart);
+    OutHitscanInfo.Vectors.EmplaceAt(1, FireRot.Vector());
+    OutHitscanInfo.Seed = SimulatedInfo.Seed;
+}
+
+void AUR_Weap_Shotgun::PlayHitscanEffects_Implementation(UUR_FireModeBasic* FireMode, const FHitscanVisualInfo& HitscanInfo)
+{
+    if (FireMode != ShotgunFireMode)
+    {
+        Super::PlayHitscanEffects_Implementation(FireMode, HitscanInfo);
+        return;
+    }
+
+    const FVector& TraceStart = HitscanInfo.Vectors[0];
+    const FVector& AimDir = HitscanInfo.Vectors[1];
+    GetPelletTraceEnds(FireMode, TraceStart, AimDir, HitscanInfo.Seed, PelletTraceEnds);
+
+    UUR_CosmeticEventSubsystem* Cosmetics = GetWorld()->GetSubsystem<UUR_CosmeticEventSubsystem>();
+    if (!Cosmetics)
+    {
+        return;
+    }
+
+    const FVector BeamStart = GetVisibleMesh()->GetSocketLocation(FireMode->GetMuzzleSocketName());
+    const bool bImportant = UUR_FunctionLibrary::IsViewingFirstPerson(URCharOwner);
+    UUR_TracerSubsystem* Tracers = GetWorld()->GetSubsystem<UUR_TracerSubsystem>();
+    const bool bUseTracers = FireMode->ShouldUseTracerRenderer() && Tracers && Tracers->IsEnabled();
+    bool bPlayedImpactSound = false;
+
+    for (const FVector& TraceEnd : PelletTraceEnds)
+    {
+        // Local trace, only for visuals
+        FHitResult Hit;
+        HitscanTrace(TraceStart, TraceEnd, Hit);
+
+        if (bUseTracers)
+        {
+            Tracers->AddTracer(FireMode->GetTracerMesh(), FireMode->GetTracerMaterial(), BeamStart, Hit.Location, FireMode->GetTracerColor(), FireMode->GetTracerWidth(), FireMode->GetTracerLifeTime());
+        }
+        else if (UFXSystemComponent* BeamComp = Cosmetics->SpawnBeamEffect(FireMode->GetBeamTemplate(), BeamStart, Hit.Location, bImportant))
+        {
+            BeamComp->SetVectorParameter(FireMode->GetBeamVectorParamName(), Hit.Location - BeamStart);
+        }
+
+        if (Hit.bBlockingHit)
+        {
+            // One impact sound for all pellets
+            Cosmetics->PlayImpact(FireMode->GetBeamImpactTemplate(), bPlayedImpactSound ? nullptr : FireMode->GetBeamImpactSound(), FTransform(Hit.ImpactNormal.Rotation(), Hit.Location));
+            bPlayedImpactSound = true;
+        }
+    }
+}
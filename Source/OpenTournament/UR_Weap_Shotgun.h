@@ -41,6 +41,61 @@ struct FShotgunSpawnBox
     int32 Count;
 };
 
+/**
+* Shotgun configuration : pellet spawn pattern and hitscan pellets.
+* The class defaults are the default configuration of the shotgun, used when no other WeaponData is assigned.
+*/
+UCLASS(BlueprintType)
+class OPENTOURNAMENT_API UUR_ShotgunData : public UUR_WeaponData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_ShotgunData()
+    {
+        WeaponName = "Shotgun";
+        WeaponGroup = 1;
+        AmmoName = "Shotgun";
+        SpawnBoxes = {
+            { FVector(5.0f, 0.0f, 0.0f), FVector(5.f, 15.f, 15.f), 2 },
+            { FVector(5.0f, -15.0f, -15.0f), FVector(5.f, 15.f, 15.f), 2 },
+            { FVector(5.0f, -15.0f, +15.0f), FVector(5.f, 15.f, 15.f), 2 },
+            { FVector(5.0f, +15.0f, -15.0f), FVector(5.f, 15.f, 15.f), 2 },
+            { FVector(5.0f, +15.0f, +15.0f), FVector(5.f, 15.f, 15.f), 2 },
+        };
+        OffsetSpread = 0.2f;
+        UseMuzzleDistance = 100.f;
+        HitscanPelletCount = 10;
+        HitscanPelletSpread = 6.f;
+    }
+
+    UPROPERTY(EditDefaultsOnly, Category = "Shotgun")
+    TArray<FShotgunSpawnBox> SpawnBoxes;
+
+    /** Used with MuzzleDistance to compute rockets orientation according to their initial offset */
+    UPROPERTY(EditDefaultsOnly, Category = "Shotgun")
+    float OffsetSpread;
+
+    /** For best results, this value should reflect the average distance from camera to weapon muzzle */
+    UPROPERTY(EditDefaultsOnly, Category = "Shotgun")
+    float UseMuzzleDistance;
+
+    /**
+    * Number of pellets in hitscan mode (when ShotgunFireMode->bIsHitscan is set).
+    *
+    * In hitscan mode, SpawnBoxes are not used.
+    * A single seed describes the whole blast : authority regenerates all pellet directions from it,
+    * traces them in one batch, and merges damage per victim.
+    * Other clients regenerate them again from the replicated seed to draw tracers.
+    */
+    UPROPERTY(EditDefaultsOnly, Category = "Shotgun")
+    int32 HitscanPelletCount;
+
+    /** Cone half-angle (degrees) of pellets in hitscan mode */
+    UPROPERTY(EditDefaultsOnly, Category = "Shotgun")
+    float HitscanPelletSpread;
+};
+
 /**
  *
  */
@@ -53,20 +108,60 @@ class OPENTOURNAMENT_API AUR_Weap_Shotgun : public AUR_Weapon
 
 public:
 
-    UPROPERTY(EditAnywhere, Category = "Weapon|Shotgun")
-    TArray<FShotgunSpawnBox> SpawnBoxes;
+#if WITH_EDITORONLY_DATA
+    /**
+    * Former inline configuration, migrated into a UUR_ShotgunData on load.
+    */
+    UPROPERTY()
+    TArray<FShotgunSpawnBox> SpawnBoxes_DEPRECATED;
 
-    /** Used with MuzzleDistance to compute rockets orientation according to their initial offset */
-    UPROPERTY(EditAnywhere, Category = "Weapon|Shotgun")
-    float OffsetSpread;
+    UPROPERTY()
+    float OffsetSpread_DEPRECATED;
 
-    /** For best results, this value should reflect the average distance from camera to weapon muzzle */
-    UPROPERTY(EditAnywhere, Category = "Weapon|Shotgun")
-    float UseMuzzleDistance;
+    UPROPERTY()
+    float UseMuzzleDistance_DEPRECATED;
+
+    UPROPERTY()
+    int32 HitscanPelletCount_DEPRECATED;
+
+    UPROPERTY()
+    float HitscanPelletSpread_DEPRECATED;
+#endif
+
+    /**
+    * Shotgun configuration. Falls back to the data class defaults when WeaponData is not a UUR_ShotgunData.
+    */
+    FORCEINLINE const UUR_ShotgunData* GetShotgunData() const
+    {
+        const UUR_ShotgunData* Data = Cast<UUR_ShotgunData>(WeaponData);
+        return Data ? Data : GetDefault<UUR_ShotgunData>();
+    }
 
     UPROPERTY(VisibleAnywhere)
     UUR_FireModeBasic* ShotgunFireMode;
 
     virtual void AuthorityShot_Implementation(UUR_FireModeBasic* FireMode, const FSimulatedShotInfo& SimulatedInfo) override;
 
+    virtual void SimulateHitscanShot_Implementation(UUR_FireModeBasic* FireMode, FSimulatedShotInfo& OutSimulatedInfo, FHitscanVisualInfo& OutHitscanInfo) override;
+    virtual void AuthorityHitscanShot_Implementation(UUR_FireModeBasic* FireMode, const FSimulatedShotInfo& SimulatedInfo, FHitscanVisualInfo& OutHitscanInfo) override;
+    virtual void PlayHitscanEffects_Implementation(UUR_FireModeBasic* FireMode, const FHitscanVisualInfo& HitscanInfo) override;
+
+protected:
+
+#if WITH_EDITORONLY_DATA
+    virtual TSubclassOf<UUR_WeaponData> GetWeaponDataClass() const override { return UUR_ShotgunData::StaticClass(); }
+    virtual void CopyDeprecatedContent(UUR_WeaponData* Data) const override;
+#endif
+
+    /**
+    * Regenerate end points of all pellets, from the blast origin, aim direction and seed.
+    */
+    void GetPelletTraceEnds(UUR_FireModeBasic* FireMode, const FVector& TraceStart, const FVector& AimDir, int32 Seed, TArray<FVector>& OutTraceEnds) const;
+
+    /** Pellet end points. Kept around to reuse allocations */
+    TArray<FVector> PelletTraceEnds;
+
+    /** Pellet sweep results. Kept around to reuse allocations */
+    TArray<TArray<FHitResult>> PelletHits;
+
 };
@@ -12,12 +12,10 @@ AUR_Weap_SniperRifle::AUR_Weap_SniperRifle(const FObjectInitializer& ObjectIniti
     /*ConstructorHelpers::FObjectFinder<USkeletalMesh> newAsset(TEXT("SkeletalMesh'/Game/SciFiWeapDark/Weapons/Darkness_SniperRifle.Darkness_SniperRifle'"));
     USkeletalMesh* helper = newAsset.Object;
     Mesh1P->SetSkeletalMesh(helper);*/
-    WeaponName = "Sniper Rifle";
+    SetDefaultWeaponData(GetMutableDefault<UUR_SniperRifleData>());
 
     /*ConstructorHelpers::FObjectFinder<USoundCue> newAssetSound(TEXT("SoundCue'/Game/SciFiWeapDark/Sound/SniperRifle/SniperRifle_Lower_Cue.SniperRifle_Lower_Cue'"));
     USoundCue* helperSound;
     helperSound = newAssetSound.Object;
     Sound->SetSound(helperSound);*/
-
-    AmmoName = "Sniper";
 }
\ No newline at end of file
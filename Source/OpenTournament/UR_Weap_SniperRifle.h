@@ -11,6 +11,23 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+* Default configuration of the sniper rifle, used when no other WeaponData is assigned.
+*/
+UCLASS()
+class OPENTOURNAMENT_API UUR_SniperRifleData : public UUR_WeaponData
+{
+    GENERATED_BODY()
+
+public:
+    UUR_SniperRifleData()
+    {
+        WeaponName = "Sniper Rifle";
+        WeaponGroup = 4;
+        AmmoName = "Sniper";
+    }
+};
+
 /**
 *
 */
@@ -13,6 +13,8 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/Engine.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetSystemLibrary.h" //debug
 #include "Net/UnrealNetwork.h"
@@ -21,8 +23,16 @@
 
 #include "OpenTournament.h"
 #include "UR_Character.h"
+#include "UR_CosmeticEventSubsystem.h"
+#include "UR_HitscanBatchSubsystem.h"
 #include "UR_InventoryComponent.h"
+#include "UR_LagCompensationComponent.h"
 #include "UR_Projectile.h"
+#include "UR_ProjectileBatchSubsystem.h"
+#include "UR_ProjectilePoolSubsystem.h"
+#include "UR_ProjectilePredictionSubsystem.h"
+#include "UR_ReplicationGraph.h"
+#include "UR_TracerSubsystem.h"
 #include "UR_PlayerController.h"
 #include "UR_FunctionLibrary.h"
 
@@ -52,21 +62,103 @@ AUR_Weapon::AUR_Weapon(const FObjectInitializer& ObjectInitializer)
 
     bReplicates = true;
 
-    BringUpTime = 0.25f;
-    PutDownTime = 0.25f;
-    CooldownDelaysPutDownByPercent = 0.5f;
-    bReducePutDownDelayByPutDownTime = false;
+    WeaponData = nullptr;
+#if WITH_EDITORONLY_DATA
+    OutOfAmmoSound_DEPRECATED = nullptr;
+    PickupSound_DEPRECATED = nullptr;
+    WeaponGroup_DEPRECATED = 0;
+    BringUpMontage_DEPRECATED = nullptr;
+    BringUpTime_DEPRECATED = 0.25f;
+    PutDownMontage_DEPRECATED = nullptr;
+    PutDownTime_DEPRECATED = 0.25f;
+    CooldownDelaysPutDownByPercent_DEPRECATED = 0.5f;
+    bReducePutDownDelayByPutDownTime_DEPRECATED = false;
+#endif
+    bHitscanFilterInScript = false;
+
+    PendingVolleyFirstId = 0;
+    PendingVolleySeed = 0;
+    PendingVolleyShotId = 0;
+    PendingVolleyServerTime = 0.f;
+    NextProjectileEventId = 0;
 
     SetCanBeDamaged(false);
 }
 
+static const FName MigratedWeaponDataName(TEXT("MigratedWeaponData"));
+
+void AUR_Weapon::PostLoad()
+{
+    Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+    // Same rule as fire modes, see UUR_FireModeBase::PostLoad
+    const bool bNativeDefaultData = WeaponData && WeaponData->HasAnyFlags(RF_ClassDefaultObject);
+    const bool bInheritedMigratedData = WeaponData && WeaponData->GetOuter() != this && WeaponData->GetFName() == MigratedWeaponDataName;
+    if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) && (!WeaponData || bNativeDefaultData || bInheritedMigratedData))
+    {
+        const TSubclassOf<UUR_WeaponData> DataClass = bNativeDefaultData ? WeaponData->GetClass() : GetWeaponDataClass();
+        UUR_WeaponData* Data = NewObject<UUR_WeaponData>(this, DataClass, MigratedWeaponDataName, RF_Public | RF_Transactional);
+        CopyDeprecatedContent(Data);
+        WeaponData = Data;
+    }
+#endif
+}
+
+#if WITH_EDITORONLY_DATA
+void AUR_Weapon::CopyDeprecatedContent(UUR_WeaponData* Data) const
+{
+    Data->WeaponName = WeaponName_DEPRECATED;
+    Data->AmmoName = AmmoName_DEPRECATED;
+    Data->WeaponGroup = WeaponGroup_DEPRECATED;
+    Data->OutOfAmmoSound = OutOfAmmoSound_DEPRECATED;
+    Data->PickupSound = PickupSound_DEPRECATED;
+    Data->BringUpMontage = BringUpMontage_DEPRECATED;
+    Data->BringUpTime = BringUpTime_DEPRECATED;
+    Data->PutDownMontage = PutDownMontage_DEPRECATED;
+    Data->PutDownTime = PutDownTime_DEPRECATED;
+    Data->CooldownDelaysPutDownByPercent = CooldownDelaysPutDownByPercent_DEPRECATED;
+    Data->bReducePutDownDelayByPutDownTime = bReducePutDownDelayByPutDownTime_DEPRECATED;
+}
+#endif
+
+void AUR_Weapon::SetDefaultWeaponData(UUR_WeaponData* Data)
+{
+    WeaponData = Data;
+
+#if WITH_EDITORONLY_DATA
+    WeaponName_DEPRECATED = Data->WeaponName;
+    AmmoName_DEPRECATED = Data->AmmoName;
+    WeaponGroup_DEPRECATED = Data->WeaponGroup;
+    OutOfAmmoSound_DEPRECATED = Data->OutOfAmmoSound;
+    PickupSound_DEPRECATED = Data->PickupSound;
+    BringUpMontage_DEPRECATED = Data->BringUpMontage;
+    BringUpTime_DEPRECATED = Data->BringUpTime;
+    PutDownMontage_DEPRECATED = Data->PutDownMontage;
+    PutDownTime_DEPRECATED = Data->PutDownTime;
+    CooldownDelaysPutDownByPercent_DEPRECATED = Data->CooldownDelaysPutDownByPercent;
+    bReducePutDownDelayByPutDownTime_DEPRECATED = Data->bReducePutDownDelayByPutDownTime;
+#endif
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 void AUR_Weapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME_CONDITION(AUR_Weapon, AmmoCount, COND_OwnerOnly);
+    FDoRepLifetimeParams AmmoParams;
+    AmmoParams.Condition = COND_OwnerOnly;
+    AmmoParams.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(AUR_Weapon, AmmoCount, AmmoParams);
+}
+
+void AUR_Weapon::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+    Super::PreReplication(ChangedPropertyTracker);
+
+    // AmmoCount
+    GamePushModelNetUpdate(this, 1);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -75,6 +167,8 @@ void AUR_Weapon::PostInitializeComponents()
 {
     Super::PostInitializeComponents();
 
+    bHitscanFilterInScript = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AUR_Weapon, HitscanShouldHitActor));
+
     TArray<UUR_FireModeBase*> FireModeComponents;
     GetComponents<UUR_FireModeBase>(FireModeComponents);
     for (auto FireMode : FireModeComponents)
@@ -108,6 +202,18 @@ void AUR_Weapon::BeginPlay()
     {
         TriggerBox->SetGenerateOverlapEvents(true);
     }
+
+    if (HasAuthority())
+    {
+        UUR_ProjectilePoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UUR_ProjectilePoolSubsystem>();
+        for (UUR_FireModeBase* FireMode : FireModes)
+        {
+            if (UUR_FireModeBasic* BasicFireMode = Cast<UUR_FireModeBasic>(FireMode))
+            {
+                PoolSubsystem->WarmUp(BasicFireMode->GetProjectileClass());
+            }
+        }
+    }
 }
 
 void AUR_Weapon::OnTriggerEnter(UPrimitiveComponent* HitComp, AActor * Other, UPrimitiveComponent * OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult & SweepResult)
@@ -117,7 +223,7 @@ void AUR_Weapon::OnTriggerEnter(UPrimitiveComponent* HitComp, AActor * Other, UP
         if (AUR_Character* URChar = Cast<AUR_Character>(Other))
         {
             GiveTo(URChar);
-            UGameplayStatics::PlaySoundAtLocation(this, PickupSound, URCharOwner->GetActorLocation());
+            UGameplayStatics::PlaySoundAtLocation(this, GetPickupSound(), URCharOwner->GetActorLocation());
         }
     }
 }
@@ -134,17 +240,79 @@ void AUR_Weapon::GiveTo(AUR_Character* NewOwner)
         SetActorHiddenInGame(true);
     }
 
+    AUR_Character* OldOwner = URCharOwner;
     SetOwner(NewOwner);
+    SetInstigator(NewOwner);
     URCharOwner = NewOwner;
+    UUR_ReplicationGraph::NotifyWeaponOwnerChanged(this, OldOwner, NewOwner);
+
+    // Weapon enters the inventory inactive, and thus goes or stays dormant. Push the new owner once.
+    UpdateNetDormancy();
+    FlushNetDormancy();
+    SetMeshesUpdating(false);
+
     if (NewOwner && NewOwner->InventoryComponent)
     {
         NewOwner->InventoryComponent->Add(this);
     }
 }
 
+void AUR_Weapon::Park()
+{
+    if (URCharOwner && URCharOwner->InventoryComponent)
+    {
+        URCharOwner->InventoryComponent->Remove(this);
+    }
+
+    ResetWeapon();
+
+    UUR_ReplicationGraph::NotifyWeaponOwnerChanged(this, GetOwner(), nullptr);
+    SetOwner(nullptr);
+    SetInstigator(nullptr);
+    URCharOwner = nullptr;
+    SetActorHiddenInGame(true);
+
+    // Inactive, so already dormant. Push the owner reset once, then keep the channel open without updates until we are given again.
+    FlushNetDormancy();
+}
+
+void AUR_Weapon::ResetWeapon()
+{
+    // Stops firing and detaches meshes
+    SetWeaponState(EWeaponState::Inactive);
+
+    FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+    TimerManager.ClearTimer(SwapAnimTimerHandle);
+    TimerManager.ClearTimer(PutDownDelayTimerHandle);
+    TimerManager.ClearTimer(RetryStartFireTimerHandle);
+
+    CurrentFireMode = nullptr;
+    DesiredFireModes.Empty();
+
+    for (UUR_FireModeBase* FireMode : FireModes)
+    {
+        if (FireMode)
+        {
+            FireMode->ResetFireMode();
+        }
+    }
+}
+
 void AUR_Weapon::OnRep_Owner()
 {
-    URCharOwner = Cast<AUR_Character>(GetOwner());
+    AUR_Character* NewOwner = Cast<AUR_Character>(GetOwner());
+    if (URCharOwner && URCharOwner != NewOwner)
+    {
+        // Recycled weapon leaving its previous owner
+        if (URCharOwner->InventoryComponent)
+        {
+            URCharOwner->InventoryComponent->Remove(this);
+        }
+        URCharOwner = nullptr;
+        ResetWeapon();
+    }
+
+    URCharOwner = NewOwner;
     SetActorHiddenInGame(true);
     CheckWeaponAttachment();
 }
@@ -161,6 +329,11 @@ void AUR_Weapon::CheckWeaponAttachment()
         {
             DetachMeshFromPawn();
         }
+        else if (URCharOwner)
+        {
+            // Inventory weapon that was never brought up
+            SetMeshesUpdating(false);
+        }
         break;
 
     default:
@@ -176,6 +349,7 @@ void AUR_Weapon::AttachMeshToPawn()
 {
     if (URCharOwner)
     {
+        SetMeshesUpdating(true);
         this->SetActorHiddenInGame(false);
         Mesh1P->AttachToComponent(URCharOwner->MeshFirstPerson, FAttachmentTransformRules::KeepRelativeTransform, URCharOwner->GetWeaponAttachPoint());
         Mesh3P->AttachToComponent(URCharOwner->GetMesh(), FAttachmentTransformRules::KeepRelativeTransform, FName(TEXT("hand_r_Socket")));
@@ -207,9 +381,20 @@ void AUR_Weapon::DetachMeshFromPawn()
     Mesh3P->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
     Mesh3P->SetHiddenInGame(true);
 
+    SetMeshesUpdating(false);
+
     bIsAttached = false;
 }
 
+void AUR_Weapon::SetMeshesUpdating(bool bUpdating)
+{
+    for (USkeletalMeshComponent* Mesh : { Mesh1P, Mesh3P })
+    {
+        Mesh->SetComponentTickEnabled(bUpdating);
+        Mesh->bNoSkeletonUpdate = !bUpdating;
+    }
+}
+
 USkeletalMeshComponent* AUR_Weapon::GetVisibleMesh() const
 {
     return UUR_FunctionLibrary::IsViewingFirstPerson(URCharOwner) ? Mesh1P : Mesh3P;
@@ -233,6 +418,8 @@ void AUR_Weapon::SetWeaponState(EWeaponState NewState)
     // check this every state change to support all edge cases
     CheckWeaponAttachment();
 
+    UpdateNetDormancy();
+
     switch (WeaponState)
     {
 
@@ -281,20 +468,20 @@ void AUR_Weapon::BringUp(float FromPosition)
     SetWeaponState(EWeaponState::BringUp);
 
     if (GetNetMode() != NM_DedicatedServer
-        && BringUpMontage
+        && GetBringUpMontage()
         && URCharOwner
         && URCharOwner->MeshFirstPerson
         && URCharOwner->MeshFirstPerson->GetAnimInstance())
     {
-        float Duration = BringUpMontage->GetPlayLength();
-        float PlayRate = Duration / BringUpTime;
+        float Duration = GetBringUpMontage()->GetPlayLength();
+        float PlayRate = Duration / GetBringUpTime();
         float StartTime = FromPosition * Duration;
         //note: start time must not account for the play rate
-        URCharOwner->MeshFirstPerson->GetAnimInstance()->Montage_Play(BringUpMontage, PlayRate, EMontagePlayReturnType::MontageLength, StartTime);
+        URCharOwner->MeshFirstPerson->GetAnimInstance()->Montage_Play(GetBringUpMontage(), PlayRate, EMontagePlayReturnType::MontageLength, StartTime);
         //TODO: 3p animation
     }
 
-    float Delay = (1.f - FromPosition) * BringUpTime;
+    float Delay = (1.f - FromPosition) * GetBringUpTime();
     if (Delay > 0.f)
     {
         GetWorld()->GetTimerManager().SetTimer(SwapAnimTimerHandle, this, &AUR_Weapon::BringUpCallback, Delay, false);
@@ -334,19 +521,19 @@ void AUR_Weapon::PutDown(float FromPosition)
     SetWeaponState(EWeaponState::PutDown);
 
     if (GetNetMode() != NM_DedicatedServer
-        && PutDownMontage
+        && GetPutDownMontage()
         && URCharOwner
         && URCharOwner->MeshFirstPerson
         && URCharOwner->MeshFirstPerson->GetAnimInstance())
     {
-        float Duration = PutDownMontage->GetPlayLength();
-        float PlayRate = Duration / PutDownTime;
+        float Duration = GetPutDownMontage()->GetPlayLength();
+        float PlayRate = Duration / GetPutDownTime();
         float StartTime = (1.f - FromPosition) * Duration;
-        URCharOwner->MeshFirstPerson->GetAnimInstance()->Montage_Play(PutDownMontage, PlayRate, EMontagePlayReturnType::MontageLength, StartTime);
+        URCharOwner->MeshFirstPerson->GetAnimInstance()->Montage_Play(GetPutDownMontage(), PlayRate, EMontagePlayReturnType::MontageLength, StartTime);
         //TODO: 3p animation
     }
 
-    float Delay = FromPosition * PutDownTime;
+    float Delay = FromPosition * GetPutDownTime();
     if (Delay > 0.f)
     {
         GetWorld()->GetTimerManager().SetTimer(SwapAnimTimerHandle, this, &AUR_Weapon::PutDownCallback, Delay, false);
@@ -393,6 +580,59 @@ void AUR_Weapon::Deactivate()
     }
 }
 
+void AUR_Weapon::UpdateNetDormancy()
+{
+    if (!HasAuthority())
+    {
+        return;
+    }
+
+    if (WeaponState == EWeaponState::Inactive && !HasProjectileEventsInFlight())
+    {
+        GetWorldTimerManager().ClearTimer(DormancyTimerHandle);
+        SetNetDormancy(DORM_DormantAll);
+    }
+    else
+    {
+        // Waking up flushes, so BringUp sends whatever changed while inactive
+        SetNetDormancy(DORM_Awake);
+
+        // Put down with projectiles in flight, their events still go through us. Go dormant once they are done.
+        if (WeaponState == EWeaponState::Inactive && !GetWorldTimerManager().IsTimerActive(DormancyTimerHandle))
+        {
+            GetWorldTimerManager().SetTimer(DormancyTimerHandle, this, &AUR_Weapon::UpdateNetDormancy, 0.5f, true);
+        }
+    }
+}
+
+bool AUR_Weapon::HasProjectileEventsInFlight()
+{
+    if (PendingVolleySpawns.Num() > 0)
+    {
+        return true;
+    }
+
+    // Projectiles may expire without detonating, forget those
+    UUR_ProjectileBatchSubsystem* BatchSubsystem = GetWorld()->GetSubsystem<UUR_ProjectileBatchSubsystem>();
+    for (auto It = ProxylessEventIds.CreateIterator(); It; ++It)
+    {
+        if (!BatchSubsystem || !BatchSubsystem->IsSimulating(It.Key()))
+        {
+            It.RemoveCurrent();
+        }
+    }
+    for (int32 i = AuthorityEventProjectiles.Num() - 1; i >= 0; i--)
+    {
+        const AUR_Projectile* Projectile = AuthorityEventProjectiles[i].Get();
+        if (!Projectile || Projectile->EventWeapon.Get() != this)
+        {
+            AuthorityEventProjectiles.RemoveAtSwap(i, 1, false);
+        }
+    }
+
+    return ProxylessEventIds.Num() > 0 || AuthorityEventProjectiles.Num() > 0;
+}
+
 void AUR_Weapon::OnRep_AmmoCount()
 {
     if (CurrentFireMode && CurrentFireMode->IsBusy())
@@ -404,10 +644,10 @@ void AUR_Weapon::OnRep_AmmoCount()
         }
         else if (auto FMContinuous = Cast<UUR_FireModeContinuous>(CurrentFireMode))
         {
-            if (AmmoCount < 1 && FMContinuous->AmmoCostPerSecond > 0.f)
+            if (AmmoCount < 1 && FMContinuous->GetAmmoCostPerSecond() > 0.f)
             {
                 // The continuous mode allows firing with 0 ammo up till the next ammo consumption
-                float Delay = 1.f / FMContinuous->AmmoCostPerSecond;
+                float Delay = 1.f / FMContinuous->GetAmmoCostPerSecond();
                 FTimerHandle Handle;
                 FTimerDelegate Callback;
                 Callback.BindLambda([this, FMContinuous]
@@ -504,7 +744,7 @@ void AUR_Weapon::RequestBringUp()
         break;
 
     case EWeaponState::PutDown:
-        BringUp(GetWorld()->GetTimerManager().GetTimerRemaining(SwapAnimTimerHandle) / PutDownTime);
+        BringUp(GetWorld()->GetTimerManager().GetTimerRemaining(SwapAnimTimerHandle) / GetPutDownTime());
         break;
 
     }
@@ -516,7 +756,7 @@ void AUR_Weapon::RequestPutDown()
     {
 
     case EWeaponState::BringUp:
-        PutDown(1.f - GetWorld()->GetTimerManager().GetTimerRemaining(SwapAnimTimerHandle) / BringUpTime);
+        PutDown(1.f - GetWorld()->GetTimerManager().GetTimerRemaining(SwapAnimTimerHandle) / GetBringUpTime());
         return;
 
     case EWeaponState::Idle:
@@ -537,15 +777,15 @@ void AUR_Weapon::RequestPutDown()
         // Used by charging firemode so we dont allow swap while charging, even if CooldownPercent is at 0.
         if (GetWorld()->TimeSince(CooldownStartTime) < 0.f)
         {
-            Delay = FMath::Max(CooldownRemaining * CooldownDelaysPutDownByPercent, 0.1f);
+            Delay = FMath::Max(CooldownRemaining * GetCooldownDelaysPutDownByPercent(), 0.1f);
         }
-        else if (CooldownRemaining > 0.f && CooldownDelaysPutDownByPercent > 0.f)
+        else if (CooldownRemaining > 0.f && GetCooldownDelaysPutDownByPercent() > 0.f)
         {
             float TotalCooldown = GetWorld()->TimeSince(CooldownStartTime) + CooldownRemaining;
-            float TotalPutDownDelay = TotalCooldown * CooldownDelaysPutDownByPercent;
-            if (bReducePutDownDelayByPutDownTime)
+            float TotalPutDownDelay = TotalCooldown * GetCooldownDelaysPutDownByPercent();
+            if (ShouldReducePutDownDelayByPutDownTime())
             {
-                TotalPutDownDelay -= PutDownTime;
+                TotalPutDownDelay -= GetPutDownTime();
             }
             float PutDownStartTime = CooldownStartTime + TotalPutDownDelay;
             Delay = PutDownStartTime - GetWorld()->GetTimeSeconds();
@@ -591,7 +831,7 @@ void AUR_Weapon::TryStartFire(UUR_FireModeBase* FireMode)
             }
             else
             {
-                UGameplayStatics::PlaySound2D(GetWorld(), OutOfAmmoSound);
+                UGameplayStatics::PlaySound2D(GetWorld(), GetOutOfAmmoSound());
             }
 
             // Don't stay as a desired mode
@@ -610,7 +850,7 @@ void AUR_Weapon::TryStartFire(UUR_FireModeBase* FireMode)
         else
         {
             // Out of ammo
-            UGameplayStatics::PlaySound2D(GetWorld(), OutOfAmmoSound);
+            UGameplayStatics::PlaySound2D(GetWorld(), GetOutOfAmmoSound());
 
             // Loop as long as user is holding fire
             FTimerDelegate TimerCallback;
@@ -725,49 +965,132 @@ void AUR_Weapon::GetValidatedFireVector(const FSimulatedShotInfo& SimulatedInfo,
     }
 }
 
-FVector AUR_Weapon::SeededRandCone(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed)
+/**
+* Counter based hash (lowbias32 finalizer), used as a stateless PRNG.
+* Unlike FMath::SRand, this does not touch any global state, so it is safe from any thread
+* and does not perturb other random streams.
+*/
+static FORCEINLINE uint32 SpreadHash(uint32 Seed, uint32 Counter)
 {
-    FVector Dir2 = Dir.GetSafeNormal();
-    if (!Dir2.IsZero() && ConeHalfAngleDeg > 0.f && ConeHalfAngleDeg < 90.f)
-    {
-        // Find a normal vector to use as our opposite side of the triangle
-        FVector OppositeVector = FVector(-Dir2.Y, Dir2.X, 0.f).GetSafeNormal();
-        if (OppositeVector.IsZero())
-        {
-            OppositeVector = FVector(0.f, -Dir2.Z, Dir2.Y).GetSafeNormal();
-        }
+    uint32 X = Seed ^ (Counter * 0x9E3779B9u);
+    X ^= X >> 16;
+    X *= 0x7FEB352Du;
+    X ^= X >> 15;
+    X *= 0x846CA68Bu;
+    X ^= X >> 16;
+    return X;
+}
+
+static FORCEINLINE float SpreadHashToUnit(uint32 Hash)
+{
+    // 24 bits of mantissa -> [0,1)
+    return (Hash >> 8) * (1.f / 16777216.f);
+}
 
-        // Max opposite side size is dictated by supplied max angle
-        float Tan = FMath::Tan(FMath::DegreesToRadians(ConeHalfAngleDeg));
-        float MaxOppositeSize = Tan * 1.f;
+float AUR_Weapon::SeededRand(int32 Seed, int32 Counter)
+{
+    return SpreadHashToUnit(SpreadHash((uint32)Seed, (uint32)Counter));
+}
 
-        // Set random seed
-        FMath::SRandInit(Seed);
+/**
+* Offset a direction within a cone, given the cone basis and the (Seed, Index) pair.
+* Picks a random point on the disc at distance 1 along Dir, with radius Tan(HalfAngle).
+*/
+static FORCEINLINE FVector SeededConeDirection(const FVector& Dir, const FVector& Basis1, const FVector& Basis2, float Tan, uint32 Seed, uint32 Index)
+{
+    const float Radius = Tan * SpreadHashToUnit(SpreadHash(Seed, 2 * Index));
+    const float Angle = (2.f * PI) * SpreadHashToUnit(SpreadHash(Seed, 2 * Index + 1));
+    float S, C;
+    FMath::SinCos(&S, &C, Angle);
+    return (Dir + Radius * (C * Basis1 + S * Basis2)).GetUnsafeNormal();
+}
 
-        // Find a random point on that opposite side
-        FVector Point = Dir2 + FMath::SRand() * MaxOppositeSize * OppositeVector;
+FVector AUR_Weapon::SeededRandCone(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed, int32 Index)
+{
+    const FVector Dir2 = Dir.GetSafeNormal();
+    if (Dir2.IsZero() || ConeHalfAngleDeg <= 0.f || ConeHalfAngleDeg >= 90.f)
+    {
+        return Dir2;
+    }
 
-        // Rotate point around axis by a random angle
-        FQuat RandRotation = FQuat(Dir2, FMath::DegreesToRadians(FMath::SRand()*360.f));
+    FVector Basis1, Basis2;
+    Dir2.FindBestAxisVectors(Basis1, Basis2);
+    const float Tan = FMath::Tan(FMath::DegreesToRadians(ConeHalfAngleDeg));
+    return SeededConeDirection(Dir2, Basis1, Basis2, Tan, (uint32)Seed, (uint32)Index);
+}
 
-        return RandRotation.RotateVector(Point).GetSafeNormal();
+void AUR_Weapon::SeededRandCones(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed, int32 Count, FVector* OutDirs)
+{
+    const FVector Dir2 = Dir.GetSafeNormal();
+    if (Dir2.IsZero() || ConeHalfAngleDeg <= 0.f || ConeHalfAngleDeg >= 90.f)
+    {
+        for (int32 i = 0; i < Count; i++)
+        {
+            OutDirs[i] = Dir2;
+        }
+        return;
     }
-    else
+
+    // Basis and cone size are shared by all directions
+    FVector Basis1, Basis2;
+    Dir2.FindBestAxisVectors(Basis1, Basis2);
+    const float Tan = FMath::Tan(FMath::DegreesToRadians(ConeHalfAngleDeg));
+    for (int32 i = 0; i < Count; i++)
     {
-        return Dir2;
+        OutDirs[i] = SeededConeDirection(Dir2, Basis1, Basis2, Tan, (uint32)Seed, (uint32)i);
     }
 }
 
+void AUR_Weapon::K2_SeededRandCones(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed, int32 Count, TArray<FVector>& OutDirs)
+{
+    OutDirs.SetNumUninitialized(FMath::Max(Count, 0));
+    SeededRandCones(Dir, ConeHalfAngleDeg, Seed, OutDirs.Num(), OutDirs.GetData());
+}
+
 AUR_Projectile* AUR_Weapon::SpawnProjectile_Implementation(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot)
 {
-    FActorSpawnParameters SpawnParams;
-    SpawnParams.Owner = GetOwner();
-    SpawnParams.Instigator = GetInstigator() ? GetInstigator() : Cast<APawn>(GetOwner());
-    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    APawn* ProjectileInstigator = GetInstigator() ? GetInstigator() : Cast<APawn>(GetOwner());
 
-    AUR_Projectile* Projectile = GetWorld()->SpawnActor<AUR_Projectile>(InProjectileClass, StartLoc, StartRot, SpawnParams);
+    const AUR_Projectile* ProjectileDefaults = InProjectileClass ? InProjectileClass->GetDefaultObject<AUR_Projectile>() : nullptr;
+    const bool bReplicateAsEvents = ProjectileDefaults && ProjectileDefaults->bReplicateAsEvents && GetNetMode() != NM_Standalone;
+    const uint16 EventId = bReplicateAsEvents ? AddToProjectileVolley(InProjectileClass, StartLoc, StartRot) : 0;
+
+    // Nothing needs an actor, simulate the projectile as plain data
+    UUR_ProjectileBatchSubsystem* BatchSubsystem = GetWorld()->GetSubsystem<UUR_ProjectileBatchSubsystem>();
+    if (BatchSubsystem->CanSimulate(ProjectileDefaults) && !ProjectileDefaults->NeedsActorProxy(GetWorld()))
+    {
+        const int32 BatchId = BatchSubsystem->Launch(InProjectileClass, StartLoc, StartRot, this, ProjectileInstigator);
+        if (bReplicateAsEvents)
+        {
+            if (!BatchSubsystem->OnProjectileDetonated.IsBoundToObject(this))
+            {
+                BatchSubsystem->OnProjectileDetonated.AddUObject(this, &AUR_Weapon::OnBatchedProjectileDetonated);
+            }
+            // Forget projectiles which expired without detonating
+            if (ProxylessEventIds.Num() >= 32)
+            {
+                for (auto It = ProxylessEventIds.CreateIterator(); It; ++It)
+                {
+                    if (!BatchSubsystem->IsSimulating(It.Key()))
+                    {
+                        It.RemoveCurrent();
+                    }
+                }
+            }
+            ProxylessEventIds.Add(BatchId, EventId);
+        }
+        return nullptr;
+    }
+
+    AUR_Projectile* Projectile = GetWorld()->GetSubsystem<UUR_ProjectilePoolSubsystem>()->Acquire(InProjectileClass, StartLoc, StartRot, GetOwner(), ProjectileInstigator);
     if (Projectile)
     {
+        if (bReplicateAsEvents)
+        {
+            Projectile->EventWeapon = this;
+            Projectile->EventId = EventId;
+            AuthorityEventProjectiles.Add(Projectile);
+        }
         Projectile->FireAt(StartRot.Vector());
         return Projectile;
     }
@@ -780,10 +1103,37 @@ AUR_Projectile* AUR_Weapon::SpawnProjectile_Implementation(TSubclassOf<AUR_Proje
 }
 
 void AUR_Weapon::HitscanTrace(const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit)
+{
+    FCollisionQueryParams Params;
+    GetHitscanQueryParams(Params);
+
+    HitscanSweep(GetWorld(), TraceStart, TraceEnd, Params, HitscanScratchHits);
+    HitscanPickHit(HitscanScratchHits, TraceStart, TraceEnd, OutHit);
+    HitscanScratchHits.Reset();
+}
+
+void AUR_Weapon::GetHitscanQueryParams(FCollisionQueryParams& OutParams) const
+{
+    OutParams = FCollisionQueryParams(SCENE_QUERY_STAT(HitscanTrace), false);
+
+    // Blueprint filter might want to accept anything, so only pre-filter for the native one
+    if (!bHitscanFilterInScript)
+    {
+        OutParams.AddIgnoredActor(GetInstigator());
+        OutParams.IgnoreMask = MASKFILTER_HITSCAN_IGNORE;
+    }
+}
+
+void AUR_Weapon::HitscanSweep(const UWorld* World, const FVector& TraceStart, const FVector& TraceEnd, const FCollisionQueryParams& Params, TArray<FHitResult>& OutHits)
 {
     ECollisionChannel TraceChannel = ECollisionChannel::ECC_GameTraceChannel2;  //WeaponTrace
     FCollisionShape SweepShape = FCollisionShape::MakeSphere(5.f);
 
+    World->SweepMultiByChannel(OutHits, TraceStart, TraceEnd, FQuat::Identity, TraceChannel, SweepShape, Params);
+}
+
+void AUR_Weapon::HitscanPickHit(const TArray<FHitResult>& Hits, const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit)
+{
     // fill in info in case we get 0 results from sweep
     OutHit.TraceStart = TraceStart;
     OutHit.TraceEnd = TraceEnd;
@@ -791,11 +1141,10 @@ void AUR_Weapon::HitscanTrace(const FVector& TraceStart, const FVector& TraceEnd
     OutHit.Location = TraceEnd;
     OutHit.ImpactNormal = (TraceEnd - TraceStart).GetSafeNormal();
 
-    TArray<FHitResult> Hits;
-    GetWorld()->SweepMultiByChannel(Hits, TraceStart, TraceEnd, FQuat(), TraceChannel, SweepShape);
+    // Results are sorted by distance, blocking hit last
     for (const FHitResult& Hit : Hits)
     {
-        if (Hit.bBlockingHit || HitscanShouldHitActor(Hit.GetActor()))
+        if (Hit.bBlockingHit || (bHitscanFilterInScript ? HitscanShouldHitActor(Hit.GetActor()) : HitscanShouldHitActor_Implementation(Hit.GetActor())))
         {
             OutHit = Hit;
             OutHit.bBlockingHit = true;
@@ -804,6 +1153,59 @@ void AUR_Weapon::HitscanTrace(const FVector& TraceStart, const FVector& TraceEnd
     }
 }
 
+bool AUR_Weapon::QueueAuthorityHitscan(UUR_FireModeBase* FireMode, const FVector& TraceStart, const FVector& TraceEnd, const FVector& AimDir, float ClientTime, float Damage, TSubclassOf<UDamageType> DamageType, bool bReplicateVisuals)
+{
+    UUR_HitscanBatchSubsystem* HitscanBatch = GetWorld()->GetSubsystem<UUR_HitscanBatchSubsystem>();
+    if (!HitscanBatch || !HitscanBatch->IsBatchingEnabled())
+    {
+        return false;
+    }
+
+    FUR_HitscanRequest Request;
+    Request.Weapon = this;
+    Request.FireMode = FireMode;
+    Request.TraceStart = TraceStart;
+    Request.TraceEnd = TraceEnd;
+    Request.AimDir = AimDir;
+    Request.ClientTime = ClientTime;
+    Request.Damage = Damage;
+    Request.DamageType = DamageType;
+    Request.bReplicateVisuals = bReplicateVisuals;
+    GetHitscanQueryParams(Request.QueryParams);
+    // The batch rewinds our own hitboxes too, never let the sweep hit them. Even for the blueprint filter.
+    Request.QueryParams.AddIgnoredActor(GetInstigator());
+    HitscanBatch->QueueRequest(Request);
+    return true;
+}
+
+void AUR_Weapon::AuthorityHitscanResolved(const FUR_HitscanRequest& Request)
+{
+    const FHitResult& Hit = Request.Hit;
+
+    if (Hit.bBlockingHit && Hit.GetActor())
+    {
+        const FVector ShotDir = (Request.TraceEnd - Request.TraceStart).GetSafeNormal();
+        UGameplayStatics::ApplyPointDamage(Hit.GetActor(), Request.Damage, ShotDir, Hit, GetInstigatorController(), this, Request.DamageType);
+    }
+
+    if (UUR_FireModeContinuous* ContinuousMode = Cast<UUR_FireModeContinuous>(Request.FireMode.Get()))
+    {
+        // Listen server host can reuse this for beam visuals
+        ContinuousMode->StoreBeamTrace(Request.TraceStart, Request.AimDir, Hit);
+    }
+
+    if (Request.bReplicateVisuals)
+    {
+        if (UUR_FireModeBasic* FireMode = Cast<UUR_FireModeBasic>(Request.FireMode.Get()))
+        {
+            FHitscanVisualInfo HitscanInfo;
+            HitscanInfo.Vectors.EmplaceAt(0, Hit.Location);
+            HitscanInfo.Vectors.EmplaceAt(1, Hit.ImpactNormal);
+            FireMode->AuthorityHitscanShotResolved(HitscanInfo);
+        }
+    }
+}
+
 bool AUR_Weapon::HitscanShouldHitActor_Implementation(AActor* Other)
 {
     //NOTE: here we can implement firing through teammates
@@ -820,16 +1222,28 @@ bool AUR_Weapon::HitscanShouldHitActor_Implementation(AActor* Other)
 
 bool AUR_Weapon::HasEnoughAmmoFor(UUR_FireModeBase* FireMode)
 {
-    return AmmoCount >= FireMode->InitialAmmoCost;
+    return AmmoCount >= FireMode->GetInitialAmmoCost();
 }
 
 void AUR_Weapon::ConsumeAmmo(int32 Amount)
 {
-    AmmoCount = FMath::Clamp(AmmoCount - Amount, 0, 999);
+    SetAmmoCount(FMath::Clamp(AmmoCount - Amount, 0, 999));
 
     OnRep_AmmoCount();
 }
 
+void AUR_Weapon::SetAmmoCount(int32 NewAmmoCount)
+{
+    if (NewAmmoCount != AmmoCount)
+    {
+        AmmoCount = NewAmmoCount;
+        GAME_MARK_PROPERTY_DIRTY(AUR_Weapon, AmmoCount, this);
+
+        // Owner HUD shows ammo of inactive weapons too
+        FlushNetDormancy();
+    }
+}
+
 
 //============================================================
 // FireModeBase interface
@@ -865,8 +1279,8 @@ float AUR_Weapon::TimeUntilReadyToFire_Implementation(UUR_FireModeBase* FireMode
     {
         // delay to check if we're late in a very quick putdown-bringup-idle scenario
         // delay by the amount of time it would take to reach idle if we called bringup now
-        float BringUpPct = GetWorld()->GetTimerManager().GetTimerRemaining(SwapAnimTimerHandle) / PutDownTime;
-        Delay = FMath::Max(0.001f, (1.f - BringUpPct) * BringUpTime);
+        float BringUpPct = GetWorld()->GetTimerManager().GetTimerRemaining(SwapAnimTimerHandle) / GetPutDownTime();
+        Delay = FMath::Max(0.001f, (1.f - BringUpPct) * GetBringUpTime());
         break;
     }
 
@@ -939,9 +1353,213 @@ void AUR_Weapon::SimulateShot_Implementation(UUR_FireModeBasic* FireMode, FSimul
     FVector FireLoc;
     FRotator FireRot;
     GetFireVector(FireLoc, FireRot);
-    OffsetFireLoc(FireLoc, FireRot, FireMode->MuzzleSocketName);
+    OffsetFireLoc(FireLoc, FireRot, FireMode->GetMuzzleSocketName());
     OutSimulatedInfo.Vectors.EmplaceAt(0, FireLoc);
     OutSimulatedInfo.Vectors.EmplaceAt(1, FireRot.Vector());
+
+    // Send spread seed so server projectile flies the same way as our fake one
+    if (FireMode->GetSpread() > 0.f)
+    {
+        OutSimulatedInfo.Seed = FMath::Max(FMath::Rand(), 1);
+        FireRot = SeededRandCone(FireRot.Vector(), FireMode->GetSpread(), OutSimulatedInfo.Seed).Rotation();
+    }
+
+    if (OutSimulatedInfo.ShotId != 0 && FireMode->GetProjectileClass())
+    {
+        SpawnFakeProjectile(FireMode->GetProjectileClass(), FireLoc, FireRot, OutSimulatedInfo.ShotId);
+    }
+}
+
+AUR_Projectile* AUR_Weapon::SpawnFakeProjectile(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot, uint8 ShotId)
+{
+    AUR_Projectile* Fake = SpawnClientProjectile(InProjectileClass, StartLoc, StartRot);
+    if (Fake)
+    {
+        Fake->ShotId = ShotId;
+
+        if (UUR_ProjectilePredictionSubsystem* Prediction = GetWorld()->GetSubsystem<UUR_ProjectilePredictionSubsystem>())
+        {
+            Prediction->AddFake(Fake);
+        }
+    }
+    return Fake;
+}
+
+AUR_Projectile* AUR_Weapon::SpawnClientProjectile(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot, float FastForwardTime)
+{
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Owner = GetOwner();
+    SpawnParams.Instigator = GetInstigator() ? GetInstigator() : Cast<APawn>(GetOwner());
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    SpawnParams.bDeferConstruction = true;
+
+    AUR_Projectile* Projectile = GetWorld()->SpawnActor<AUR_Projectile>(InProjectileClass, StartLoc, StartRot, SpawnParams);
+    if (Projectile)
+    {
+        Projectile->bFakeProjectile = true;
+        Projectile->SpawnFastForwardTime = FastForwardTime;
+        Projectile->SetReplicates(false);
+        Projectile->FinishSpawning(FTransform(StartRot, StartLoc));
+    }
+    return Projectile;
+}
+
+//============================================================
+// Projectile events
+//============================================================
+
+uint16 AUR_Weapon::AddToProjectileVolley(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot)
+{
+    // One volley per class
+    if (PendingVolleySpawns.Num() > 0 && PendingVolleyClass != InProjectileClass)
+    {
+        FlushProjectileVolley();
+    }
+
+    if (PendingVolleySpawns.Num() == 0)
+    {
+        PendingVolleyClass = InProjectileClass;
+        PendingVolleyFirstId = NextProjectileEventId;
+        PendingVolleyServerTime = GetWorld()->GetTimeSeconds();
+        GetWorldTimerManager().SetTimerForNextTick(this, &AUR_Weapon::FlushProjectileVolley);
+    }
+
+    PendingVolleySpawns.Emplace(StartRot, StartLoc);
+    return NextProjectileEventId++;
+}
+
+void AUR_Weapon::FlushProjectileVolley()
+{
+    if (PendingVolleySpawns.Num() == 0)
+    {
+        return;
+    }
+
+    FUR_ProjectileVolley Volley;
+    BuildProjectileVolley(PendingVolleyClass, PendingVolleySpawns, Volley);
+    Volley.ProjectileClass = PendingVolleyClass;
+    Volley.FirstId = PendingVolleyFirstId;
+    Volley.Seed = PendingVolleySeed;
+    Volley.ShotId = PendingVolleyShotId;
+    Volley.ServerTime = PendingVolleyServerTime;
+
+    PendingVolleySpawns.Reset();
+    PendingVolleySeed = 0;
+    PendingVolleyShotId = 0;
+
+    MulticastProjectileVolley(Volley);
+}
+
+void AUR_Weapon::BuildProjectileVolley(TSubclassOf<AUR_Projectile> InProjectileClass, const TArray<FTransform>& Spawns, FUR_ProjectileVolley& OutVolley) const
+{
+    OutVolley.Origin = Spawns[0].GetLocation();
+    OutVolley.Direction = Spawns[0].GetRotation().GetForwardVector();
+    for (int32 i = 1; i < Spawns.Num(); i++)
+    {
+        OutVolley.ExtraOffsets.Emplace(Spawns[i].GetLocation() - Spawns[0].GetLocation());
+        OutVolley.ExtraDirections.Emplace(Spawns[i].GetRotation().GetForwardVector());
+    }
+}
+
+void AUR_Weapon::ExpandProjectileVolley(const FUR_ProjectileVolley& Volley, TArray<FTransform>& OutSpawns) const
+{
+    OutSpawns.Emplace(Volley.Direction.Rotation(), Volley.Origin);
+    const int32 NumExtra = FMath::Min(Volley.ExtraOffsets.Num(), Volley.ExtraDirections.Num());
+    for (int32 i = 0; i < NumExtra; i++)
+    {
+        OutSpawns.Emplace(Volley.ExtraDirections[i].Rotation(), Volley.Origin + Volley.ExtraOffsets[i]);
+    }
+}
+
+void AUR_Weapon::MulticastProjectileVolley_Implementation(const FUR_ProjectileVolley& Volley)
+{
+    if (GetNetMode() != NM_Client || !Volley.ProjectileClass)
+    {
+        return;
+    }
+
+    TArray<FTransform> Spawns;
+    ExpandProjectileVolley(Volley, Spawns);
+
+    // Catch up with the server projectiles
+    float FastForwardTime = 0.f;
+    if (const AGameStateBase* GS = GetWorld()->GetGameState())
+    {
+        const float MaxFastForwardTime = Volley.ProjectileClass->GetDefaultObject<AUR_Projectile>()->MaxFastForwardTime;
+        FastForwardTime = FMath::Clamp(GS->GetServerWorldTimeSeconds() - Volley.ServerTime, 0.f, MaxFastForwardTime);
+    }
+
+    int32 FirstSpawn = 0;
+
+    // Our own predicted shot, the fake projectile plays the part of the first projectile
+    if (Volley.ShotId != 0)
+    {
+        UUR_ProjectilePredictionSubsystem* Prediction = GetWorld()->GetSubsystem<UUR_ProjectilePredictionSubsystem>();
+        FUR_FakeProjectile Fake;
+        if (Prediction && Prediction->ConsumeFake(GetInstigator() ? GetInstigator() : Cast<APawn>(GetOwner()), Volley.ShotId, Fake))
+        {
+            FirstSpawn = 1;
+            if (AUR_Projectile* FakeProjectile = Fake.Projectile.Get())
+            {
+                RegisterEventProjectile(Volley.FirstId, FakeProjectile);
+            }
+        }
+    }
+
+    for (int32 i = FirstSpawn; i < Spawns.Num(); i++)
+    {
+        if (AUR_Projectile* Projectile = SpawnClientProjectile(Volley.ProjectileClass, Spawns[i].GetLocation(), Spawns[i].Rotator(), FastForwardTime))
+        {
+            RegisterEventProjectile(Volley.FirstId + i, Projectile);
+        }
+    }
+}
+
+void AUR_Weapon::RegisterEventProjectile(uint16 EventId, AUR_Projectile* Projectile)
+{
+    // Forget projectiles which exploded on their own
+    if (EventProjectiles.Num() >= 32)
+    {
+        for (auto It = EventProjectiles.CreateIterator(); It; ++It)
+        {
+            if (!It.Value().IsValid())
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+    EventProjectiles.Add(EventId, Projectile);
+}
+
+void AUR_Weapon::AuthorityProjectileDetonated(uint16 EventId, const FVector& Location, const FVector& Normal)
+{
+    // Make sure clients know about the projectile before it explodes
+    FlushProjectileVolley();
+
+    MulticastProjectileDetonated(EventId, Location, Normal);
+}
+
+void AUR_Weapon::OnBatchedProjectileDetonated(int32 BatchId, UClass* ProjectileClass, const FVector& Location, const FVector& Normal)
+{
+    uint16 EventId;
+    if (ProxylessEventIds.RemoveAndCopyValue(BatchId, EventId))
+    {
+        AuthorityProjectileDetonated(EventId, Location, Normal);
+    }
+}
+
+void AUR_Weapon::MulticastProjectileDetonated_Implementation(uint16 EventId, FVector_NetQuantize Location, FVector_NetQuantizeNormal Normal)
+{
+    if (GetNetMode() != NM_Client)
+    {
+        return;
+    }
+
+    TWeakObjectPtr<AUR_Projectile> Projectile;
+    if (EventProjectiles.RemoveAndCopyValue(EventId, Projectile) && Projectile.IsValid())
+    {
+        Projectile->Explode(Location, Normal);
+    }
 }
 
 void AUR_Weapon::SimulateHitscanShot_Implementation(UUR_FireModeBasic* FireMode, FSimulatedShotInfo& OutSimulatedInfo, FHitscanVisualInfo& OutHitscanInfo)
@@ -953,10 +1571,10 @@ void AUR_Weapon::SimulateHitscanShot_Implementation(UUR_FireModeBasic* FireMode,
     OutSimulatedInfo.Vectors.EmplaceAt(0, FireLoc);
     OutSimulatedInfo.Vectors.EmplaceAt(1, FireRot.Vector());
 
-    if (FireMode->Spread > 0.f)
+    if (FireMode->GetSpread() > 0.f)
     {
-        int32 Seed = FMath::GetRandSeed();
-        FireRot = SeededRandCone(FireRot.Vector(), FireMode->Spread, Seed).Rotation();
+        const int32 Seed = FMath::Max(FMath::Rand(), 1);
+        FireRot = SeededRandCone(FireRot.Vector(), FireMode->GetSpread(), Seed).Rotation();
         OutSimulatedInfo.Seed = Seed;
         /**
         * NOTE: might want to rethink about this a bit.
@@ -970,7 +1588,7 @@ void AUR_Weapon::SimulateHitscanShot_Implementation(UUR_FireModeBasic* FireMode,
         */
     }
 
-    FVector TraceEnd = FireLoc + FireMode->HitscanTraceDistance * FireRot.Vector();
+    FVector TraceEnd = FireLoc + FireMode->GetHitscanTraceDistance() * FireRot.Vector();
 
     FHitResult Hit;
     HitscanTrace(FireLoc, TraceEnd, Hit);
@@ -981,25 +1599,34 @@ void AUR_Weapon::SimulateHitscanShot_Implementation(UUR_FireModeBasic* FireMode,
 
 void AUR_Weapon::AuthorityShot_Implementation(UUR_FireModeBasic* FireMode, const FSimulatedShotInfo& SimulatedInfo)
 {
-    if (FireMode->ProjectileClass)
+    if (FireMode->GetProjectileClass())
     {
         FVector FireLoc;
         FRotator FireRot;
-        GetValidatedFireVector(SimulatedInfo, FireLoc, FireRot, FireMode->MuzzleSocketName);
+        GetValidatedFireVector(SimulatedInfo, FireLoc, FireRot, FireMode->GetMuzzleSocketName());
 
-        // Add spread (if we do implement client-side projectiles, we'll need to replicate a Seed)
-        // OR just replicate the altered FireRot? see note above
-        if (FireMode->Spread > 0.f)
+        // Add spread, using the client's seed so predicted projectiles match
+        if (FireMode->GetSpread() > 0.f)
         {
-            FireRot = FMath::VRandCone(FireRot.Vector(), FMath::DegreesToRadians(FireMode->Spread)).Rotation();
+            const int32 Seed = (SimulatedInfo.Seed != 0) ? SimulatedInfo.Seed : FMath::Rand();
+            FireRot = SeededRandCone(FireRot.Vector(), FireMode->GetSpread(), Seed).Rotation();
         }
 
-        SpawnProjectile(FireMode->ProjectileClass, FireLoc, FireRot);
+        AUR_Projectile* Projectile = SpawnProjectile(FireMode->GetProjectileClass(), FireLoc, FireRot);
+        if (Projectile)
+        {
+            Projectile->ShotId = SimulatedInfo.ShotId;
+        }
+        if (PendingVolleySpawns.Num() > 0)
+        {
+            PendingVolleySeed = SimulatedInfo.Seed;
+            PendingVolleyShotId = SimulatedInfo.ShotId;
+        }
 
         // Charged mode consumes ammo while charging, not when releasing shot
         if (!Cast<UUR_FireModeCharged>(FireMode))
         {
-            ConsumeAmmo(FireMode->InitialAmmoCost);
+            ConsumeAmmo(FireMode->GetInitialAmmoCost());
         }
     }
 }
@@ -1009,40 +1636,60 @@ void AUR_Weapon::AuthorityHitscanShot_Implementation(UUR_FireModeBasic* FireMode
     FVector TraceStart;
     FRotator FireRot;
     GetValidatedFireVector(SimulatedInfo, TraceStart, FireRot);
+    const FVector AimDir = FireRot.Vector();
+
+    if (FireMode->GetSpread() > 0.f)
+    {
+        FireRot = SeededRandCone(FireRot.Vector(), FireMode->GetSpread(), SimulatedInfo.Seed).Rotation();
+    }
 
-    if (FireMode->Spread > 0.f)
+    FVector TraceEnd = TraceStart + FireMode->GetHitscanTraceDistance() * FireRot.Vector();
+
+    // Charged mode consumes ammo while charging, not when releasing shot
+    const bool bIsCharged = (Cast<UUR_FireModeCharged>(FireMode) != nullptr);
+    if (!bIsCharged)
     {
-        FireRot = SeededRandCone(FireRot.Vector(), FireMode->Spread, SimulatedInfo.Seed).Rotation();
+        ConsumeAmmo(FireMode->GetInitialAmmoCost());
     }
 
-    FVector TraceEnd = TraceStart + FireMode->HitscanTraceDistance * FireRot.Vector();
+    // Charged mode resets its charge state in the multicast, which must not be deferred
+    if (!bIsCharged && QueueAuthorityHitscan(FireMode, TraceStart, TraceEnd, AimDir, SimulatedInfo.ClientTime, FireMode->GetHitscanDamage(), FireMode->GetHitscanDamageType(), true))
+    {
+        // Leave OutHitscanInfo empty, visuals are multicasted when the batch is resolved
+        return;
+    }
 
     FHitResult Hit;
-    HitscanTrace(TraceStart, TraceEnd, Hit);
+    {
+        // Trace against hitboxes as the shooter was seeing them
+        FUR_ScopedLagCompensation LagCompensation(URCharOwner, SimulatedInfo.ClientTime);
+        HitscanTrace(TraceStart, TraceEnd, Hit);
+    }
 
     if (Hit.bBlockingHit && Hit.GetActor())
     {
-        float Damage = FireMode->HitscanDamage;
-        auto DamType = FireMode->HitscanDamageType;
+        float Damage = FireMode->GetHitscanDamage();
+        auto DamType = FireMode->GetHitscanDamageType();
         UGameplayStatics::ApplyPointDamage(Hit.GetActor(), Damage, FireRot.Vector(), Hit, GetInstigatorController(), this, DamType);
     }
 
     OutHitscanInfo.Vectors.EmplaceAt(0, Hit.Location);
     OutHitscanInfo.Vectors.EmplaceAt(1, Hit.ImpactNormal);
-
-    // Charged mode consumes ammo while charging, not when releasing shot
-    if (!Cast<UUR_FireModeCharged>(FireMode))
-    {
-        ConsumeAmmo(FireMode->InitialAmmoCost);
-    }
 }
 
 void AUR_Weapon::PlayFireEffects_Implementation(UUR_FireModeBasic* FireMode)
 {
+    UUR_CosmeticEventSubsystem* Cosmetics = GetWorld()->GetSubsystem<UUR_CosmeticEventSubsystem>();
+    if (!Cosmetics)
+    {
+        return;
+    }
+
     if (UUR_FunctionLibrary::IsViewingFirstPerson(URCharOwner))
     {
-        UGameplayStatics::SpawnSoundAttached(FireMode->FireSound, Mesh1P, FireMode->MuzzleSocketName, FVector(0), EAttachLocation::SnapToTarget);
-        UUR_FunctionLibrary::SpawnEffectAttached(FireMode->MuzzleFlashTemplate, FTransform(), Mesh1P, FireMode->MuzzleSocketName, EAttachLocation::SnapToTargetIncludingScale);
+        // Our own weapon is never culled nor budgeted
+        Cosmetics->PlaySoundAttached(FireMode->GetFireSound(), Mesh1P, FireMode->GetMuzzleSocketName(), true);
+        Cosmetics->SpawnEffectAttached(FireMode->GetMuzzleFlashTemplate(), Mesh1P, FireMode->GetMuzzleSocketName(), true);
         if (URCharOwner->MeshFirstPerson && URCharOwner->MeshFirstPerson->GetAnimInstance())
         {
             //TODO: fire animation should be in weapon, maybe even in firemode?
@@ -1051,28 +1698,43 @@ void AUR_Weapon::PlayFireEffects_Implementation(UUR_FireModeBasic* FireMode)
     }
     else
     {
-        UGameplayStatics::SpawnSoundAttached(FireMode->FireSound, Mesh3P, FireMode->MuzzleSocketName, FVector(0), EAttachLocation::SnapToTarget);
-        UUR_FunctionLibrary::SpawnEffectAttached(FireMode->MuzzleFlashTemplate, FTransform(), Mesh3P, FireMode->MuzzleSocketName, EAttachLocation::SnapToTargetIncludingScale);
+        Cosmetics->PlaySoundAttached(FireMode->GetFireSound(), Mesh3P, FireMode->GetMuzzleSocketName());
+        Cosmetics->SpawnEffectAttached(FireMode->GetMuzzleFlashTemplate(), Mesh3P, FireMode->GetMuzzleSocketName());
         //TODO: play 3p anim
     }
 }
 
 void AUR_Weapon::PlayHitscanEffects_Implementation(UUR_FireModeBasic* FireMode, const FHitscanVisualInfo& HitscanInfo)
 {
-    const FVector& BeamStart = GetVisibleMesh()->GetSocketLocation(FireMode->MuzzleSocketName);
+    const FVector& BeamStart = GetVisibleMesh()->GetSocketLocation(FireMode->GetMuzzleSocketName());
     const FVector& BeamEnd = HitscanInfo.Vectors[0];
     FVector BeamVector = BeamEnd - BeamStart;
 
-    UFXSystemComponent* BeamComp = UUR_FunctionLibrary::SpawnEffectAtLocation(this, FireMode->BeamTemplate, FTransform(BeamStart));
-    if (BeamComp)
+    UUR_CosmeticEventSubsystem* Cosmetics = GetWorld()->GetSubsystem<UUR_CosmeticEventSubsystem>();
+    if (!Cosmetics)
     {
-        BeamComp->SetVectorParameter(FireMode->BeamVectorParamName, BeamVector);
+        return;
+    }
+
+    UUR_TracerSubsystem* Tracers = GetWorld()->GetSubsystem<UUR_TracerSubsystem>();
+    if (FireMode->ShouldUseTracerRenderer() && Tracers && Tracers->IsEnabled())
+    {
+        Tracers->AddTracer(FireMode->GetTracerMesh(), FireMode->GetTracerMaterial(), BeamStart, BeamEnd, FireMode->GetTracerColor(), FireMode->GetTracerWidth(), FireMode->GetTracerLifeTime());
+    }
+    else
+    {
+        // Beams span from our own muzzle, always show ours
+        const bool bImportant = UUR_FunctionLibrary::IsViewingFirstPerson(URCharOwner);
+        UFXSystemComponent* BeamComp = Cosmetics->SpawnBeamEffect(FireMode->GetBeamTemplate(), BeamStart, BeamEnd, bImportant);
+        if (BeamComp)
+        {
+            BeamComp->SetVectorParameter(FireMode->GetBeamVectorParamName(), BeamVector);
+        }
     }
 
     // Impact fx & sound
     const FVector& ImpactNormal = HitscanInfo.Vectors[1];
-    UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), FireMode->BeamImpactTemplate, FTransform(ImpactNormal.Rotation(), BeamEnd));
-    UGameplayStatics::PlaySoundAtLocation(GetWorld(), FireMode->BeamImpactSound, BeamEnd);
+    Cosmetics->PlayImpact(FireMode->GetBeamImpactTemplate(), FireMode->GetBeamImpactSound(), FTransform(ImpactNormal.Rotation(), BeamEnd));
 }
 
 
@@ -1094,12 +1756,12 @@ void AUR_Weapon::ChargeLevel_Implementation(UUR_FireModeCharged* FireMode, int32
         // If we don't have enough ammo for next charge, stop charging
         if (AmmoCount < 1)
         {
-            FireMode->BlockNextCharge(FireMode->MaxChargeHoldTime);
+            FireMode->BlockNextCharge(FireMode->GetMaxChargeHoldTime());
         }
     }
 
     // Default hitscan damage = linear scale
-    FireMode->HitscanDamage = FMath::Lerp(FireMode->HitscanDamageMin, FireMode->HitscanDamageMax, FireMode->GetTotalChargePercent(false));
+    FireMode->ChargedHitscanDamage = FMath::Lerp(FireMode->GetHitscanDamageMin(), FireMode->GetHitscanDamageMax(), FireMode->GetTotalChargePercent(false));
 
     GEngine->AddOnScreenDebugMessage(118, 3.f, FColor::Blue, *FString::Printf(TEXT("CHARGE LEVEL %i (%i)"), ChargeLevel, bWasPaused?1:0));
 }
@@ -1128,13 +1790,30 @@ void AUR_Weapon::ChargeLevel_Implementation(UUR_FireModeCharged* FireMode, int32
 void AUR_Weapon::SimulateContinuousHitCheck_Implementation(UUR_FireModeContinuous* FireMode)
 {
     /**
-    * TODO: Client side hitreg, under some specific conditions.
+    * Client side hitreg for straight beams, as described in FireModeContinuous.h
     *
-    * For a straight beam we can try an implementation as described in FireModeContinuous.h
-    *
-    * For something like minigun, we should just do server hit detection,
+    * For something like minigun, we just do server hit detection,
     * because I don't feel like syncing up each individual randomly spreaded bullet.
     */
+    if (!FireMode->IsClientSideHitReg())
+    {
+        return;
+    }
+
+    FVector FireLoc;
+    FRotator FireRot;
+    GetFireVector(FireLoc, FireRot);
+
+    FVector TraceEnd = FireLoc + FireMode->GetTraceDistance() * FireRot.Vector();
+
+    FHitResult Hit;
+    HitscanTrace(FireLoc, TraceEnd, Hit);
+    FireMode->StoreBeamTrace(FireLoc, FireRot.Vector(), Hit);
+
+    if (Hit.bBlockingHit && FireMode->ShouldReportHit(Hit.GetActor()))
+    {
+        FireMode->ClientRegisterHit(Hit.GetActor());
+    }
 }
 
 void AUR_Weapon::AuthorityStartContinuousFire_Implementation(UUR_FireModeContinuous* FireMode)
@@ -1145,13 +1824,13 @@ void AUR_Weapon::AuthorityStartContinuousFire_Implementation(UUR_FireModeContinu
         return;
     }
 
-    ConsumeAmmo(FireMode->InitialAmmoCost);
+    ConsumeAmmo(FireMode->GetInitialAmmoCost());
     FireMode->AmmoCostAccumulator = 0.f;
 }
 
 void AUR_Weapon::AuthorityContinuousHitCheck_Implementation(UUR_FireModeContinuous* FireMode)
 {
-    FireMode->AmmoCostAccumulator += FireMode->AmmoCostPerSecond * FireMode->HitCheckInterval;
+    FireMode->AmmoCostAccumulator += FireMode->GetAmmoCostPerSecond() * FireMode->HitCheckInterval;
     while (FireMode->AmmoCostAccumulator >= 1.f)
     {
         //NOTE: Here we consume ammo before the fact, not after.
@@ -1170,21 +1849,51 @@ void AUR_Weapon::AuthorityContinuousHitCheck_Implementation(UUR_FireModeContinuo
     FVector FireLoc;
     FRotator FireRot;
     GetFireVector(FireLoc, FireRot);
+    const FVector AimDir = FireRot.Vector();
 
-    if (FireMode->Spread > 0.f)
+    if (FireMode->IsClientSideHitReg())
     {
-        FireRot = FMath::VRandCone(FireRot.Vector(), FMath::DegreesToRadians(FireMode->Spread)).Rotation();
+        // Client decides hits. We only observe, to validate its reports.
+        // Client traces straight along its aim (see SimulateContinuousHitCheck), so do we.
+        // Ping is an approximation of how far behind the client is seeing things.
+        const APlayerState* PS = URCharOwner ? URCharOwner->GetPlayerState() : nullptr;
+        const float ClientTime = GetWorld()->GetTimeSeconds() - (PS ? 0.001f * PS->ExactPing : 0.f);
+
+        FHitResult Hit;
+        {
+            FUR_ScopedLagCompensation LagCompensation(URCharOwner, ClientTime);
+            HitscanTrace(FireLoc, FireLoc + FireMode->GetTraceDistance() * AimDir, Hit);
+        }
+
+        if (Hit.bBlockingHit && FireMode->ShouldReportHit(Hit.GetActor()))
+        {
+            FireMode->AuthorityObservedHit(Hit);
+        }
+        return;
     }
 
-    FVector TraceEnd = FireLoc + FireMode->TraceDistance * FireRot.Vector();
+    if (FireMode->GetSpread() > 0.f)
+    {
+        FireRot = FMath::VRandCone(FireRot.Vector(), FMath::DegreesToRadians(FireMode->GetSpread())).Rotation();
+    }
+
+    FVector TraceEnd = FireLoc + FireMode->GetTraceDistance() * FireRot.Vector();
+
+    if (QueueAuthorityHitscan(FireMode, FireLoc, TraceEnd, AimDir, GetWorld()->GetTimeSeconds(), FireMode->GetDamage(), FireMode->GetDamageType(), false))
+    {
+        return;
+    }
 
     FHitResult Hit;
     HitscanTrace(FireLoc, TraceEnd, Hit);
 
+    // Listen server host can reuse this for beam visuals
+    FireMode->StoreBeamTrace(FireLoc, AimDir, Hit);
+
     if (Hit.bBlockingHit && Hit.GetActor())
     {
-        float Damage = FireMode->Damage;
-        auto DamType = FireMode->DamageType;
+        float Damage = FireMode->GetDamage();
+        auto DamType = FireMode->GetDamageType();
         UGameplayStatics::ApplyPointDamage(Hit.GetActor(), Damage, FireRot.Vector(), Hit, GetInstigatorController(), this, DamType);
     }
 }
@@ -1194,12 +1903,36 @@ void AUR_Weapon::AuthorityStopContinuousFire_Implementation(UUR_FireModeContinuo
     //Nothing to do
 }
 
+void AUR_Weapon::AuthorityContinuousHitsConfirmed_Implementation(UUR_FireModeContinuous* FireMode, AActor* Target, int32 HitCount)
+{
+    // Use the hit server observed, with its component, bone and direction
+    FHitResult Hit;
+    FVector ShotDir;
+    if (FireMode->GetLastObservedHit(Target, Hit))
+    {
+        ShotDir = (Hit.TraceEnd - Hit.TraceStart).GetSafeNormal();
+    }
+    else
+    {
+        // Accepted through tolerance only
+        FVector FireLoc;
+        FRotator FireRot;
+        GetFireVector(FireLoc, FireRot);
+
+        const FVector TargetLoc = Target->GetActorLocation();
+        ShotDir = (TargetLoc - FireLoc).GetSafeNormal();
+        Hit = FHitResult(Target, nullptr, TargetLoc, -ShotDir);
+    }
+
+    UGameplayStatics::ApplyPointDamage(Target, FireMode->GetDamage() * HitCount, ShotDir, Hit, GetInstigatorController(), this, FireMode->GetDamageType());
+}
+
 void AUR_Weapon::StartContinuousEffects_Implementation(UUR_FireModeContinuous* FireMode)
 {
     if (!FireMode->BeamComponent || FireMode->BeamComponent->IsBeingDestroyed())
     {
         //UKismetSystemLibrary::PrintString(this, TEXT("NEW PARTICLE"));
-        FireMode->BeamComponent = UUR_FunctionLibrary::SpawnEffectAttached(FireMode->BeamTemplate, FTransform(), GetVisibleMesh(), FireMode->MuzzleSocketName, EAttachLocation::SnapToTargetIncludingScale);
+        FireMode->BeamComponent = UUR_FunctionLibrary::SpawnEffectAttached(FireMode->GetBeamTemplate(), FTransform(), GetVisibleMesh(), FireMode->GetMuzzleSocketName(), EAttachLocation::SnapToTargetIncludingScale);
     }
     if (FireMode->BeamComponent)
     {
@@ -1209,7 +1942,7 @@ void AUR_Weapon::StartContinuousEffects_Implementation(UUR_FireModeContinuous* F
     if (!FireMode->FireLoopAudioComponent || FireMode->FireLoopAudioComponent->IsBeingDestroyed())
     {
         //UKismetSystemLibrary::PrintString(this, TEXT("NEW SOUND"));
-        FireMode->FireLoopAudioComponent = UGameplayStatics::SpawnSoundAttached(FireMode->FireLoopSound, GetVisibleMesh(), FireMode->MuzzleSocketName, FVector(0), EAttachLocation::SnapToTarget, true);
+        FireMode->FireLoopAudioComponent = UGameplayStatics::SpawnSoundAttached(FireMode->GetFireLoopSound(), GetVisibleMesh(), FireMode->GetMuzzleSocketName(), FVector(0), EAttachLocation::SnapToTarget, true);
     }
     if (FireMode->FireLoopAudioComponent)
     {
@@ -1225,21 +1958,27 @@ void AUR_Weapon::UpdateContinuousEffects_Implementation(UUR_FireModeContinuous*
         FRotator FireRot;
         GetFireVector(FireLoc, FireRot);
 
-        if (FireMode->Spread > 0.f)
+        // Only trace at the visual rate, or when aim moved significantly
+        FHitResult Hit;
+        if (!FireMode->GetCachedBeamTrace(FireLoc, FireRot.Vector(), Hit))
         {
-            FireRot = FMath::VRandCone(FireRot.Vector(), FMath::DegreesToRadians(FireMode->Spread)).Rotation();
-        }
+            FVector TraceDir = FireRot.Vector();
+            if (FireMode->GetSpread() > 0.f)
+            {
+                TraceDir = FMath::VRandCone(TraceDir, FMath::DegreesToRadians(FireMode->GetSpread()));
+            }
 
-        FVector TraceEnd = FireLoc + FireMode->TraceDistance * FireRot.Vector();
+            FVector TraceEnd = FireLoc + FireMode->GetTraceDistance() * TraceDir;
 
-        FHitResult Hit;
-        HitscanTrace(FireLoc, TraceEnd, Hit);
+            HitscanTrace(FireLoc, TraceEnd, Hit);
+            FireMode->StoreBeamTrace(FireLoc, FireRot.Vector(), Hit);
+        }
 
         FVector BeamVector = Hit.Location - FireMode->BeamComponent->GetComponentLocation();
         BeamVector = FireMode->BeamComponent->GetComponentTransform().InverseTransformVector(BeamVector);
 
-        FireMode->BeamComponent->SetVectorParameter(FireMode->BeamVectorParamName, BeamVector);
-        FireMode->BeamComponent->SetVectorParameter(FireMode->BeamImpactNormalParamName, Hit.ImpactNormal);
+        FireMode->BeamComponent->SetVectorParameter(FireMode->GetBeamVectorParamName(), BeamVector);
+        FireMode->BeamComponent->SetVectorParameter(FireMode->GetBeamImpactNormalParamName(), Hit.ImpactNormal);
 
         //TODO: There is an issue here, if player/viewer changes 1P/3P perspective while firing,
         // the effect (and sound) need to be re-attached to the appropriate weapon mesh.
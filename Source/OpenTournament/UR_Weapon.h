@@ -5,12 +5,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
 #include "GameFramework/Actor.h"
 
 #include "UR_FireModeBase.h"
 #include "UR_FireModeBasic.h"
 #include "UR_FireModeCharged.h"
 #include "UR_FireModeContinuous.h"
+#include "UR_WeaponData.h"
 
 #include "UR_Weapon.generated.h"
 
@@ -25,6 +27,7 @@ class USkeletalMeshComponent;
 class USoundBase;
 class UFXSystemAsset;
 class UAnimMontage;
+struct FUR_HitscanRequest;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -47,6 +50,59 @@ enum class EWeaponState : uint8
     MAX             UMETA(Hidden)
 };
 
+/**
+* Projectiles spawned by one shot, replicated as a single event instead of one actor channel per projectile.
+* Only for projectile classes with bReplicateAsEvents.
+*
+* Default layout (see AUR_Weapon::BuildProjectileVolley) is the first projectile's location and direction,
+* and the other projectiles relative to it.
+*/
+USTRUCT()
+struct FUR_ProjectileVolley
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TSubclassOf<AUR_Projectile> ProjectileClass;
+
+    UPROPERTY()
+    FVector_NetQuantize10 Origin;
+
+    UPROPERTY()
+    FVector_NetQuantizeNormal Direction;
+
+    /** Locations of other projectiles, relative to Origin */
+    UPROPERTY()
+    TArray<FVector_NetQuantize10> ExtraOffsets;
+
+    UPROPERTY()
+    TArray<FVector_NetQuantizeNormal> ExtraDirections;
+
+    /** Spread seed of the shot, for weapon-specific layouts */
+    UPROPERTY()
+    int32 Seed;
+
+    /** Server time the projectiles were spawned, clients simulate them forward from there */
+    UPROPERTY()
+    float ServerTime;
+
+    /** Event id of the first projectile, others follow consecutively */
+    UPROPERTY()
+    uint16 FirstId;
+
+    /** Predicted shot, see FSimulatedShotInfo::ShotId */
+    UPROPERTY()
+    uint8 ShotId;
+
+    FUR_ProjectileVolley()
+        : Seed(0)
+        , ServerTime(0.f)
+        , FirstId(0)
+        , ShotId(0)
+    {
+    }
+};
+
 /**
 * Event dispatcher.
 * Notify the weapon has changed state.
@@ -70,6 +126,7 @@ class OPENTOURNAMENT_API AUR_Weapon : public AActor
 protected:	
     AUR_Weapon(const FObjectInitializer& ObjectInitializer);
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
     virtual void PostInitializeComponents() override;
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +168,20 @@ public:
     UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
     void GiveTo(AUR_Character* NewOwner);
 
+    /**
+    * Take the weapon away from its owner and keep it aside, hidden and net dormant, to be given again later.
+    * Used to recycle inventories across respawns instead of destroying and spawning weapons.
+    */
+    UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
+    void Park();
+
+    /**
+    * Drop all runtime state (weapon state, timers, fire modes) so the weapon behaves as freshly spawned.
+    * Does not touch AmmoCount.
+    */
+    UFUNCTION(BlueprintCallable)
+    virtual void ResetWeapon();
+
 protected:
 
     virtual void OnRep_Owner() override;
@@ -118,6 +189,15 @@ protected:
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // General properties
 
+public:
+
+    /**
+    * Shared static configuration of this weapon (names, sounds, swap animations and timings). Read it through the getters.
+    * When not set, the defaults of the data class are used.
+    */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon", Meta = (DisplayPriority = "1"))
+    UUR_WeaponData* WeaponData;
+
 protected:
 
     UPROPERTY(VisibleAnywhere, Category = "Weapon")
@@ -126,22 +206,56 @@ protected:
     UPROPERTY(VisibleAnywhere, Category = "Weapon")
     USkeletalMeshComponent* Mesh3P;
 
-    UPROPERTY(EditAnywhere, Category = "Weapon")
-    USoundBase* OutOfAmmoSound;
-
 public:
 
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
-    USoundBase* PickupSound;
-
     UPROPERTY(EditAnywhere, ReplicatedUsing = OnRep_AmmoCount, Category = "Weapon")
     int32 AmmoCount;
 
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
-    FString WeaponName;
+#if WITH_EDITORONLY_DATA
+    /**
+    * Former inline configuration, only loaded to be migrated into WeaponData. See PostLoad.
+    */
+    UPROPERTY()
+    USoundBase* OutOfAmmoSound_DEPRECATED;
+
+    UPROPERTY()
+    USoundBase* PickupSound_DEPRECATED;
+
+    UPROPERTY()
+    FString WeaponName_DEPRECATED;
+
+    UPROPERTY()
+    FString AmmoName_DEPRECATED;
+
+    UPROPERTY()
+    int32 WeaponGroup_DEPRECATED;
+
+    UPROPERTY()
+    UAnimMontage* BringUpMontage_DEPRECATED;
+
+    UPROPERTY()
+    float BringUpTime_DEPRECATED;
 
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon")
-    FString AmmoName;
+    UPROPERTY()
+    UAnimMontage* PutDownMontage_DEPRECATED;
+
+    UPROPERTY()
+    float PutDownTime_DEPRECATED;
+
+    UPROPERTY()
+    float CooldownDelaysPutDownByPercent_DEPRECATED;
+
+    UPROPERTY()
+    bool bReducePutDownDelayByPutDownTime_DEPRECATED;
+#endif
+
+    virtual void PostLoad() override;
+
+    /**
+    * Change AmmoCount on authority, waking the weapon for one update if it is dormant.
+    * AmmoCount is push model replicated, it must not be written directly.
+    */
+    void SetAmmoCount(int32 NewAmmoCount);
 
 protected:
 
@@ -165,6 +279,48 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Weapon")
     USkeletalMeshComponent* GetVisibleMesh() const;
 
+    FORCEINLINE const UUR_WeaponData* GetWeaponData() const { return WeaponData ? WeaponData : GetDefault<UUR_WeaponData>(); }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Weapon")
+    FORCEINLINE FString GetWeaponName() const { return GetWeaponData()->WeaponName; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Weapon")
+    FORCEINLINE FString GetAmmoName() const { return GetWeaponData()->AmmoName; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Weapon")
+    FORCEINLINE int32 GetWeaponGroup() const { return GetWeaponData()->WeaponGroup; }
+
+    FORCEINLINE USoundBase* GetOutOfAmmoSound() const { return GetWeaponData()->OutOfAmmoSound; }
+    FORCEINLINE USoundBase* GetPickupSound() const { return GetWeaponData()->PickupSound; }
+    FORCEINLINE UAnimMontage* GetBringUpMontage() const { return GetWeaponData()->BringUpMontage; }
+    FORCEINLINE float GetBringUpTime() const { return GetWeaponData()->BringUpTime; }
+    FORCEINLINE UAnimMontage* GetPutDownMontage() const { return GetWeaponData()->PutDownMontage; }
+    FORCEINLINE float GetPutDownTime() const { return GetWeaponData()->PutDownTime; }
+    FORCEINLINE float GetCooldownDelaysPutDownByPercent() const { return GetWeaponData()->CooldownDelaysPutDownByPercent; }
+    FORCEINLINE bool ShouldReducePutDownDelayByPutDownTime() const { return GetWeaponData()->bReducePutDownDelayByPutDownTime; }
+
+protected:
+
+#if WITH_EDITORONLY_DATA
+    /**
+    * Data class matching this weapon type, created when migrating the deprecated inline configuration.
+    */
+    virtual TSubclassOf<UUR_WeaponData> GetWeaponDataClass() const { return UUR_WeaponData::StaticClass(); }
+
+    /**
+    * Copy the deprecated inline configuration into Data. Subclasses copy their own after calling Super.
+    */
+    virtual void CopyDeprecatedContent(UUR_WeaponData* Data) const;
+#endif
+
+    /**
+    * For native weapon constructors. Use the class defaults of a data class as default configuration.
+    * Deprecated inline properties get the same values, so blueprints saved before WeaponData migrate with them.
+    */
+    void SetDefaultWeaponData(UUR_WeaponData* Data);
+
+public:
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // Weapon Attachment
 
@@ -193,6 +349,12 @@ protected:
     UFUNCTION()
     void DetachMeshFromPawn();
 
+    /**
+    * Toggle ticking and bone updates of both meshes.
+    * Inventory weapons only need them between AttachMeshToPawn and DetachMeshFromPawn.
+    */
+    void SetMeshesUpdating(bool bUpdating);
+
 public:
 
     /**
@@ -208,44 +370,28 @@ public:
 public:
 
     //============================================================
-    // Weapon animations & timings
+    // WeaponStates Core
     //============================================================
 
-    UPROPERTY(EditAnywhere, Category = "Weapon")
-    UAnimMontage* BringUpMontage;
-
-    UPROPERTY(EditAnywhere, Category = "Weapon")
-    float BringUpTime;
-
-    UPROPERTY(EditAnywhere, Category = "Weapon")
-    UAnimMontage* PutDownMontage;
+    UPROPERTY(BlueprintReadOnly)
+    EWeaponState WeaponState;
 
-    UPROPERTY(EditAnywhere, Category = "Weapon")
-    float PutDownTime;
+    UFUNCTION()
+    virtual void SetWeaponState(EWeaponState NewState);
 
     /**
-    * When requesting putdown during cooldown, delay by a percentage of that cooldown.
-    * If cooldown is 1 second and this is at 75%, you can putdown 0.75s after firing.
+    * Inactive weapons only change on ammo pickups, so they are net dormant.
+    * Ammo changes flush dormancy (see SetAmmoCount), and leaving the Inactive state wakes the weapon up.
+    * Weapons put down with event projectiles in flight stay awake until those are done, their events being multicast by the weapon.
     */
-    UPROPERTY(EditAnywhere, Category = "Weapon", Meta = (ClampMin = "0", ClampMax = "1"))
-    float CooldownDelaysPutDownByPercent;
+    void UpdateNetDormancy();
 
     /**
-    * Whether to automatically reduce the above delay by the PutDownTime itself.
-    * In the above scenario and with 0.3 put down time, you can putdown 0.45s after firing.
+    * Authority: whether projectile volley or detonation events may still be multicast by this weapon.
     */
-    UPROPERTY(EditAnywhere, Category = "Weapon", Meta = (EditCondition = "CooldownDelaysPutDownByPercent>0"))
-    bool bReducePutDownDelayByPutDownTime;
+    bool HasProjectileEventsInFlight();
 
-    //============================================================
-    // WeaponStates Core
-    //============================================================
-
-    UPROPERTY(BlueprintReadOnly)
-    EWeaponState WeaponState;
-
-    UFUNCTION()
-    virtual void SetWeaponState(EWeaponState NewState);
+    FTimerHandle DormancyTimerHandle;
 
     UPROPERTY(BlueprintAssignable)
     FWeaponStateChangedSignature OnWeaponStateChanged;
@@ -340,15 +486,82 @@ public:
     UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
     virtual void GetValidatedFireVector(const FSimulatedShotInfo& SimulatedInfo, FVector& FireLoc, FRotator& FireRot, FName OffsetSocketName = NAME_None);
 
+    /**
+    * Deterministic cone spread.
+    * Uses a stateless hash of (Seed, Index), so same inputs give the same direction on any machine and any thread.
+    * Index allows deriving many directions from a single seed (eg. shotgun pellets).
+    */
     UFUNCTION(BlueprintCallable)
-    static FVector SeededRandCone(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed);
+    static FVector SeededRandCone(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed, int32 Index = 0);
+
+    /**
+    * Generate Count cone directions from one seed.
+    * Same results as calling SeededRandCone with Index 0 to Count-1.
+    */
+    static void SeededRandCones(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed, int32 Count, FVector* OutDirs);
 
+    UFUNCTION(BlueprintCallable, Meta = (DisplayName = "Seeded Rand Cones"))
+    static void K2_SeededRandCones(const FVector& Dir, float ConeHalfAngleDeg, int32 Seed, int32 Count, TArray<FVector>& OutDirs);
+
+    /**
+    * Stateless random float in [0,1) for a given (Seed, Counter) pair.
+    */
+    static float SeededRand(int32 Seed, int32 Counter);
+
+    /**
+    * Spawn a projectile, from the projectile pool.
+    * Returns null if the projectile is simulated without actor, see AUR_Projectile::NeedsActorProxy.
+    */
     UFUNCTION(BlueprintNativeEvent, BlueprintAuthorityOnly, BlueprintCallable)
     AUR_Projectile* SpawnProjectile(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot);
 
+    /**
+    * Spawn a client-side fake projectile for a predicted shot.
+    * It is replaced by the server projectile with the same ShotId once replicated.
+    */
+    AUR_Projectile* SpawnFakeProjectile(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot, uint8 ShotId);
+
+    /**
+    * Spawn a client-side projectile which deals no damage, for predicted shots and projectile events.
+    * It is simulated forward by FastForwardTime right away.
+    */
+    AUR_Projectile* SpawnClientProjectile(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot, float FastForwardTime = 0.f);
+
     UFUNCTION(BlueprintCallable)
     void HitscanTrace(const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit);
 
+    /**
+    * Query params for hitscan sweeps.
+    * When HitscanShouldHitActor is not overridden in blueprint, the default rejections
+    * (instigator, non-damageable projectiles) are done by the physics pre-filter,
+    * so the first non-blocking result is usually the one we want.
+    */
+    virtual void GetHitscanQueryParams(FCollisionQueryParams& OutParams) const;
+
+    /**
+    * Scene query part of HitscanTrace.
+    * Does not touch any actor, so it is safe to run off the game thread.
+    */
+    static void HitscanSweep(const UWorld* World, const FVector& TraceStart, const FVector& TraceEnd, const FCollisionQueryParams& Params, TArray<FHitResult>& OutHits);
+
+    /**
+    * Hit selection part of HitscanTrace.
+    * Picks the first blocking or accepted hit from sweep results. Game thread only.
+    */
+    void HitscanPickHit(const TArray<FHitResult>& Hits, const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit);
+
+    /**
+    * Queue an authority hitscan trace, to be resolved with all other traces at the end of the frame.
+    * Damage is applied on resolve, and FireModeBasic visuals are multicasted if requested.
+    * Returns false if batching is disabled, in which case caller should trace immediately.
+    */
+    bool QueueAuthorityHitscan(UUR_FireModeBase* FireMode, const FVector& TraceStart, const FVector& TraceEnd, const FVector& AimDir, float ClientTime, float Damage, TSubclassOf<UDamageType> DamageType, bool bReplicateVisuals);
+
+    /**
+    * Called by the hitscan batch once a queued trace has been resolved.
+    */
+    virtual void AuthorityHitscanResolved(const FUR_HitscanRequest& Request);
+
     /**
     * On hitscan trace overlap,
     * Return whether hitscan should hit target or fire through.
@@ -356,6 +569,81 @@ public:
     UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Weapon")
     bool HitscanShouldHitActor(AActor* Other);
 
+protected:
+
+    /**
+    * Whether HitscanShouldHitActor is overridden in blueprint.
+    * If not, hit selection calls the native implementation directly.
+    */
+    bool bHitscanFilterInScript;
+
+    /** Reused by HitscanTrace to avoid allocating on every trace */
+    TArray<FHitResult> HitscanScratchHits;
+
+    //============================================================
+    // Projectile events
+    //============================================================
+
+public:
+
+    /**
+    * Pack projectiles spawned this frame into a volley event.
+    * Override along with ExpandProjectileVolley to use a more compact, weapon-specific layout.
+    */
+    virtual void BuildProjectileVolley(TSubclassOf<AUR_Projectile> InProjectileClass, const TArray<FTransform>& Spawns, FUR_ProjectileVolley& OutVolley) const;
+
+    /**
+    * Client: unpack spawn transforms of a volley event.
+    */
+    virtual void ExpandProjectileVolley(const FUR_ProjectileVolley& Volley, TArray<FTransform>& OutSpawns) const;
+
+    /**
+    * Authority: replicate explosion of an event projectile.
+    */
+    void AuthorityProjectileDetonated(uint16 EventId, const FVector& Location, const FVector& Normal);
+
+protected:
+
+    /**
+    * Authority: add a projectile to the volley sent at the end of the frame.
+    * Returns its event id.
+    */
+    uint16 AddToProjectileVolley(TSubclassOf<AUR_Projectile> InProjectileClass, const FVector& StartLoc, const FRotator& StartRot);
+
+    UFUNCTION()
+    void FlushProjectileVolley();
+
+    UFUNCTION(NetMulticast, Reliable)
+    void MulticastProjectileVolley(const FUR_ProjectileVolley& Volley);
+
+    UFUNCTION(NetMulticast, Unreliable)
+    void MulticastProjectileDetonated(uint16 EventId, FVector_NetQuantize Location, FVector_NetQuantizeNormal Normal);
+
+    void OnBatchedProjectileDetonated(int32 BatchId, UClass* ProjectileClass, const FVector& Location, const FVector& Normal);
+
+    void RegisterEventProjectile(uint16 EventId, AUR_Projectile* Projectile);
+
+    /** Authority: volley being collected */
+    TSubclassOf<AUR_Projectile> PendingVolleyClass;
+    TArray<FTransform> PendingVolleySpawns;
+    uint16 PendingVolleyFirstId;
+    int32 PendingVolleySeed;
+    uint8 PendingVolleyShotId;
+    float PendingVolleyServerTime;
+
+    uint16 NextProjectileEventId;
+
+    /** Authority: event ids of projectiles simulated without actor, by batch id */
+    TMap<int32, uint16> ProxylessEventIds;
+
+    /** Authority: projectile actors whose events go through us, until they detonate or return to the pool */
+    TArray<TWeakObjectPtr<AUR_Projectile>> AuthorityEventProjectiles;
+
+    /** Client: projectiles spawned from volley events, by event id */
+    TMap<uint16, TWeakObjectPtr<AUR_Projectile>> EventProjectiles;
+
+public:
+
     UFUNCTION(BlueprintCallable)
     bool HasEnoughAmmoFor(UUR_FireModeBase* FireMode);
 
@@ -445,6 +733,8 @@ public:
 
     virtual void AuthorityStopContinuousFire_Implementation(UUR_FireModeContinuous* FireMode) override;
 
+    virtual void AuthorityContinuousHitsConfirmed_Implementation(UUR_FireModeContinuous* FireMode, AActor* Target, int32 HitCount) override;
+
     virtual void StartContinuousEffects_Implementation(UUR_FireModeContinuous* FireMode) override;
 
     virtual void UpdateContinuousEffects_Implementation(UUR_FireModeContinuous* FireMode, float DeltaTime) override;
@@ -71,7 +71,7 @@ FText AUR_WeaponBase::GetItemName_Implementation()
 {
     if (WeaponClass)
     {
-        return FText::FromString(WeaponClass->GetDefaultObject<AUR_Weapon>()->WeaponName);
+        return FText::FromString(WeaponClass->GetDefaultObject<AUR_Weapon>()->GetWeaponName());
     }
 
     return FText::FromString(TEXT("void"));
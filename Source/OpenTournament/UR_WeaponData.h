@@ -0,0 +1,94 @@
+// Copyright (c) 2019-2020 Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "UR_WeaponData.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+
+class UAnimMontage;
+class USoundBase;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+* Shared static configuration of a weapon : names, sounds, swap animations and timings.
+*
+* One asset is shared by every instance of the weapon, which only keeps a pointer to it along with its runtime state
+* (ammo, weapon state, timers). Weapons read through the asset on each use, so edits apply without respawning them.
+*
+* Native weapons default to the class defaults of their own data class (eg. UUR_PistolData), see AUR_Weapon::SetDefaultWeaponData.
+* Weapons without data use the defaults of UUR_WeaponData.
+* Their former inline properties are editor only, and migrated into a data object on load (see AUR_Weapon::PostLoad).
+* Fire mode content lives in UUR_FireModeData, referenced by each fire mode component.
+*/
+UCLASS(BlueprintType)
+class OPENTOURNAMENT_API UUR_WeaponData : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    UUR_WeaponData()
+    {
+        WeaponGroup = 0;
+        OutOfAmmoSound = nullptr;
+        PickupSound = nullptr;
+        BringUpMontage = nullptr;
+        BringUpTime = 0.25f;
+        PutDownMontage = nullptr;
+        PutDownTime = 0.25f;
+        CooldownDelaysPutDownByPercent = 0.5f;
+        bReducePutDownDelayByPutDownTime = false;
+    }
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    FString WeaponName;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    FString AmmoName;
+
+    /**
+    * Weapon selection group, bound to the number keys.
+    * If another weapon of the inventory already uses this group, the next free one is used.
+    */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon", Meta = (ClampMin = "0", ClampMax = "9"))
+    int32 WeaponGroup;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    USoundBase* OutOfAmmoSound;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    USoundBase* PickupSound;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    UAnimMontage* BringUpMontage;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    float BringUpTime;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    UAnimMontage* PutDownMontage;
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+    float PutDownTime;
+
+    /**
+    * When requesting putdown during cooldown, delay by a percentage of that cooldown.
+    * If cooldown is 1 second and this is at 75%, you can putdown 0.75s after firing.
+    */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon", Meta = (ClampMin = "0", ClampMax = "1"))
+    float CooldownDelaysPutDownByPercent;
+
+    /**
+    * Whether to automatically reduce the above delay by the PutDownTime itself.
+    * In the above scenario and with 0.3 put down time, you can putdown 0.45s after firing.
+    */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon", Meta = (EditCondition = "CooldownDelaysPutDownByPercent>0"))
+    bool bReducePutDownDelayByPutDownTime;
+};
@@ -10,5 +10,8 @@ public class OpenTournamentServerTarget : TargetRules
         Type = TargetType.Server;
         LinkType = TargetLinkType.Modular;
         ExtraModuleNames.Add("OpenTournament");
+
+        // Only mark dirty properties are compared, see GAME_MARK_PROPERTY_DIRTY
+        bWithPushModel = true;
     }
 }